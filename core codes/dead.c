@@ -2,22 +2,14 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include "dead.h"
+#include "evlog.h"
+#include "probe.h"
+#include "workload.h"
 
-#define MAX_RESOURCES 10
-#define MAX_PROCESSES 10
-
-typedef struct {
-    char processName[20];
-    int allocation[MAX_RESOURCES];
-    int max[MAX_RESOURCES];
-    int need[MAX_RESOURCES];
-    int priority;
-} ResourceAllocation;
-
-int available[MAX_RESOURCES];
-ResourceAllocation processes[MAX_PROCESSES];
-int processCount = 0;
-int resourceCount = 0;
+static BankerState defaultState;
+BankerState *bankerState = &defaultState;
+bool bankerVerbose = true;
 
 void calculateNeed(ResourceAllocation *process, int resourceCount) {
     for (int i = 0; i < resourceCount; i++) {
@@ -26,96 +18,225 @@ void calculateNeed(ResourceAllocation *process, int resourceCount) {
 }
 
 void addProcess(const char *processName, int *allocation, int *max, int priority) {
-    if (processCount >= MAX_PROCESSES) {
+    if (bankerState->processCount >= MAX_BANKER_PROCESSES) {
         printf("Cannot add more processes. Limit reached.\n");
         return;
     }
 
-    ResourceAllocation *process = &processes[processCount];
+    ResourceAllocation *process = &bankerState->processes[bankerState->processCount];
     strcpy(process->processName, processName);
-    memcpy(process->allocation, allocation, sizeof(int) * resourceCount);
-    memcpy(process->max, max, sizeof(int) * resourceCount);
+    memcpy(process->allocation, allocation, sizeof(int) * bankerState->resourceCount);
+    memcpy(process->max, max, sizeof(int) * bankerState->resourceCount);
     process->priority = priority;
 
-    calculateNeed(process, resourceCount);
+    calculateNeed(process, bankerState->resourceCount);
+    for (int j = 0; j < bankerState->resourceCount; j++) {
+        if (allocation[j] > 0) EVLOG(ENGINE_DEAD, EVENT_GRANT, bankerState->processCount, j, allocation[j]);
+    }
 
-    processCount++;
-    printf("Process %s added successfully.\n", processName);
+    bankerState->processCount++;
+    if (bankerVerbose) printf("Process %s added successfully.\n", processName);
 }
 
 void releaseResources(const char *processName) {
-    for (int i = 0; i < processCount; i++) {
-        if (strcmp(processes[i].processName, processName) == 0) {
-            for (int j = 0; j < resourceCount; j++) {
-                available[j] += processes[i].allocation[j];
+    for (int i = 0; i < bankerState->processCount; i++) {
+        if (strcmp(bankerState->processes[i].processName, processName) == 0) {
+            for (int j = 0; j < bankerState->resourceCount; j++) {
+                bankerState->available[j] += bankerState->processes[i].allocation[j];
+                if (bankerState->processes[i].allocation[j] > 0) EVLOG(ENGINE_DEAD, EVENT_RELEASE, i, j, bankerState->processes[i].allocation[j]);
             }
-            for (int k = i; k < processCount - 1; k++) {
-                processes[k] = processes[k + 1];
+            for (int k = i; k < bankerState->processCount - 1; k++) {
+                bankerState->processes[k] = bankerState->processes[k + 1];
             }
-            processCount--;
-            printf("Resources from process %s released.\n", processName);
+            bankerState->processCount--;
+            if (bankerVerbose) printf("Resources from process %s released.\n", processName);
             return;
         }
     }
     printf("Process %s not found.\n", processName);
 }
 
-void runBankersAlgorithm() {
+// Safety algorithm: fills sequence with process indices in a safe order and
+// returns whether every process can finish
+bool findSafeSequence(int *sequence, int *sequenceCount) {
+    PROBE_SCOPE(PROBE_TIMER_SAFETY_CHECK);
+    PROBE_COUNT(PROBE_DEAD_SAFETY_CHECKS, 1);
     int work[MAX_RESOURCES];
-    bool finish[MAX_PROCESSES] = {false};
-    char safeSequence[MAX_PROCESSES][20];
-    int safeSequenceCount = 0;
+    bool finish[MAX_BANKER_PROCESSES] = {false};
+    *sequenceCount = 0;
 
-    memcpy(work, available, sizeof(int) * resourceCount);
+    memcpy(work, bankerState->available, sizeof(int) * bankerState->resourceCount);
 
     bool progress = true;
     while (progress) {
         progress = false;
-        for (int i = 0; i < processCount; i++) {
+        for (int i = 0; i < bankerState->processCount; i++) {
             if (!finish[i]) {
                 bool canProceed = true;
-                for (int j = 0; j < resourceCount; j++) {
-                    if (processes[i].need[j] > work[j]) {
+                for (int j = 0; j < bankerState->resourceCount; j++) {
+                    PROBE_COUNT(PROBE_DEAD_NEED_COMPARISONS, 1);
+                    if (bankerState->processes[i].need[j] > work[j]) {
                         canProceed = false;
                         break;
                     }
                 }
                 if (canProceed) {
-                    for (int j = 0; j < resourceCount; j++) {
-                        work[j] += processes[i].allocation[j];
+                    for (int j = 0; j < bankerState->resourceCount; j++) {
+                        work[j] += bankerState->processes[i].allocation[j];
                     }
                     finish[i] = true;
-                    strcpy(safeSequence[safeSequenceCount++], processes[i].processName);
+                    EVLOG(ENGINE_DEAD, EVENT_CHECK, i, *sequenceCount, 1);
+                    sequence[(*sequenceCount)++] = i;
                     progress = true;
                 }
             }
         }
     }
 
-    bool allFinished = true;
-    for (int i = 0; i < processCount; i++) {
-        if (!finish[i]) {
-            allFinished = false;
+    EVLOG(ENGINE_DEAD, EVENT_CHECK, -1, *sequenceCount, *sequenceCount == bankerState->processCount);
+    return *sequenceCount == bankerState->processCount;
+}
+
+// Resource-request algorithm: grant request to a registered process only if
+// it stays within the declared maximum, is available now, and leaves the
+// system safe. A refused request leaves the state unchanged.
+bool requestResources(const char *processName, int *request) {
+    int index = -1;
+    for (int i = 0; i < bankerState->processCount; i++) {
+        if (strcmp(bankerState->processes[i].processName, processName) == 0) {
+            index = i;
             break;
         }
     }
+    if (index < 0) return false;
+
+    ResourceAllocation *process = &bankerState->processes[index];
+    for (int j = 0; j < bankerState->resourceCount; j++) {
+        if (request[j] > process->need[j] || request[j] > bankerState->available[j]) return false;
+    }
+
+    for (int j = 0; j < bankerState->resourceCount; j++) {
+        bankerState->available[j] -= request[j];
+        process->allocation[j] += request[j];
+        process->need[j] -= request[j];
+    }
 
-    if (allFinished) {
+    int sequence[MAX_BANKER_PROCESSES];
+    int sequenceCount;
+    if (findSafeSequence(sequence, &sequenceCount)) {
+        for (int j = 0; j < bankerState->resourceCount; j++) {
+            if (request[j] > 0) EVLOG(ENGINE_DEAD, EVENT_GRANT, index, j, request[j]);
+        }
+        return true;
+    }
+
+    // Unsafe: roll back the tentative grant
+    for (int j = 0; j < bankerState->resourceCount; j++) {
+        bankerState->available[j] += request[j];
+        process->allocation[j] -= request[j];
+        process->need[j] += request[j];
+    }
+    return false;
+}
+
+void runBankersAlgorithm() {
+    int safeSequence[MAX_BANKER_PROCESSES];
+    int safeSequenceCount = 0;
+
+    if (findSafeSequence(safeSequence, &safeSequenceCount)) {
         printf("System is in a safe state.\nSafe sequence: ");
         for (int i = 0; i < safeSequenceCount; i++) {
-            printf("%s%s", safeSequence[i], i == safeSequenceCount - 1 ? "\n" : " -> ");
+            printf("%s%s", bankerState->processes[safeSequence[i]].processName,
+                   i == safeSequenceCount - 1 ? "\n" : " -> ");
         }
     } else {
         printf("System is in a deadlock state.\n");
     }
 }
 
-int main() {
+#ifndef DEAD_NO_MAIN
+// Admit a generated job file through the Banker's check. Each job asks for
+// half its claim up front and is admitted only if the state stays safe; the
+// oldest process finishes when the table is full:
+// dead --workload FILE [--available N]
+static int runWorkload(int argc, char *argv[]) {
+    int perResource = 20;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--available") == 0) perResource = atoi(argv[i + 1]);
+    }
+
+    WorkloadFileHeader header;
+    FILE *file = workload_open(argv[2], WORKLOAD_JOBS, &header);
+    if (file == NULL || header.resourceCount > MAX_RESOURCES) {
+        fprintf(stderr, "Cannot read job workload %s\n", argv[2]);
+        if (file) fclose(file);
+        return 1;
+    }
+
+    bankerVerbose = false;
+    bankerState->resourceCount = (int)header.resourceCount;
+    bankerState->processCount = 0;
+    for (int j = 0; j < bankerState->resourceCount; j++) bankerState->available[j] = perResource;
+
+    long long admitted = 0, unsafe = 0, unavailable = 0;
+    int sequence[MAX_BANKER_PROCESSES];
+    int sequenceCount;
+
+    EVLOG_START_FROM_ENV();
+    PROBE_HW_START();
+
+    WorkloadJob job;
+    while (fread(&job, sizeof(job), 1, file) == 1) {
+        if (bankerState->processCount == MAX_BANKER_PROCESSES)
+            releaseResources(bankerState->processes[0].processName);
+
+        int allocation[MAX_RESOURCES];
+        bool fits = true;
+        for (int j = 0; j < bankerState->resourceCount; j++) {
+            allocation[j] = (job.demand[j] + 1) / 2;
+            if (job.demand[j] > perResource || allocation[j] > bankerState->available[j]) fits = false;
+        }
+        if (!fits) {
+            unavailable++;
+            continue;
+        }
+
+        char name[20];
+        snprintf(name, sizeof(name), "J%d", job.id);
+        for (int j = 0; j < bankerState->resourceCount; j++) bankerState->available[j] -= allocation[j];
+        addProcess(name, allocation, job.demand, job.priority);
+
+        if (findSafeSequence(sequence, &sequenceCount)) {
+            admitted++;
+        } else {
+            releaseResources(name);
+            unsafe++;
+        }
+    }
+
+    PROBE_HW_STOP();
+    PROBE_REPORT();
+    EVLOG_STOP();
+    fclose(file);
+
+    printf("Jobs: %llu, admitted: %lld, denied as unsafe: %lld, denied for lack of resources: %lld\n",
+           (unsigned long long)header.count, admitted, unsafe, unavailable);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 3 && strcmp(argv[1], "--workload") == 0)
+        return runWorkload(argc, argv);
+
+    // Record step events to $EVLOG_PATH (builds with EVLOG_ENABLED)
+    EVLOG_START_FROM_ENV();
+    PROBE_HW_START();
+
     // Example inputs
-    resourceCount = 3;  // Assume 3 types of resources
-    available[0] = 10;
-    available[1] = 5;
-    available[2] = 7;
+    bankerState->resourceCount = 3;  // Assume 3 types of resources
+    bankerState->available[0] = 10;
+    bankerState->available[1] = 5;
+    bankerState->available[2] = 7;
 
     int allocation1[] = {1, 0, 0};
     int max1[] = {7, 5, 3};
@@ -131,5 +252,9 @@ int main() {
 
     runBankersAlgorithm();
 
+    PROBE_HW_STOP();
+    PROBE_REPORT();
+    EVLOG_STOP();
     return 0;
 }
+#endif
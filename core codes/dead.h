@@ -0,0 +1,37 @@
+#ifndef DEAD_H
+#define DEAD_H
+
+#include <stdbool.h>
+
+#define MAX_RESOURCES 10
+#define MAX_BANKER_PROCESSES 10
+
+typedef struct {
+    char processName[20];
+    int allocation[MAX_RESOURCES];
+    int max[MAX_RESOURCES];
+    int need[MAX_RESOURCES];
+    int priority;
+} ResourceAllocation;
+
+// All Banker's algorithm state lives in one plain-data struct (no pointers)
+// so it can be snapshotted and mapped back in place. The engine works on
+// whatever bankerState points at; it starts out at a static instance.
+typedef struct {
+    int available[MAX_RESOURCES];
+    ResourceAllocation processes[MAX_BANKER_PROCESSES];
+    int processCount;
+    int resourceCount;
+} BankerState;
+
+extern BankerState *bankerState;
+extern bool bankerVerbose;  // print a line per added/released process
+
+void calculateNeed(ResourceAllocation *process, int resourceCount);
+void addProcess(const char *processName, int *allocation, int *max, int priority);
+void releaseResources(const char *processName);
+bool findSafeSequence(int *sequence, int *sequenceCount);
+bool requestResources(const char *processName, int *request);
+void runBankersAlgorithm();
+
+#endif
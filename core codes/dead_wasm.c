@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include "dead.h"
+#include "wasm.h"
+
+// WebAssembly exports for the Banker's algorithm. Vectors are passed as
+// resourceCount ints; the safe sequence is left in module memory as process
+// indices and read through an Int32Array view of deadSafeSequence().
+
+static int safeSequence[MAX_BANKER_PROCESSES];
+static int safeSequenceCount = 0;
+
+WASM_EXPORT void deadReset(int resources, const int *availableVector) {
+    // Adding and releasing processes would otherwise print a line per call
+    bankerVerbose = false;
+    bankerState->resourceCount = resources < MAX_RESOURCES ? resources : MAX_RESOURCES;
+    bankerState->processCount = 0;
+    safeSequenceCount = 0;
+    for (int i = 0; i < bankerState->resourceCount; i++) {
+        bankerState->available[i] = availableVector[i];
+    }
+}
+
+// Returns the new process index, or -1 when the process table is full
+WASM_EXPORT int deadAddProcess(const int *allocation, const int *max, int priority) {
+    char name[20];
+    int before = bankerState->processCount;
+    snprintf(name, sizeof(name), "P%d", bankerState->processCount);
+    addProcess(name, (int*)allocation, (int*)max, priority);
+    return bankerState->processCount > before ? before : -1;
+}
+
+WASM_EXPORT void deadRelease(int index) {
+    if (index >= 0 && index < bankerState->processCount) {
+        releaseResources(bankerState->processes[index].processName);
+    }
+}
+
+// Returns 1 if the state is safe; the sequence covers the processes that can finish
+WASM_EXPORT int deadCheck(void) {
+    return findSafeSequence(safeSequence, &safeSequenceCount);
+}
+
+WASM_EXPORT int *deadSafeSequence(void) {
+    return safeSequence;
+}
+
+WASM_EXPORT int deadSafeSequenceCount(void) {
+    return safeSequenceCount;
+}
@@ -0,0 +1,372 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include "evlog.h"
+
+// Single-producer/single-consumer ring owned by one recording thread
+typedef struct {
+    _Atomic uint64_t head;   // next slot the owner writes
+    char pad[56];
+    _Atomic uint64_t tail;   // next slot the consumer reads
+    uint64_t mask;
+    uint16_t thread;
+    Event *events;
+} EventRing;
+
+atomic_bool evlog_active = false;
+
+static EventRing *rings[EVLOG_MAX_THREADS];
+static _Atomic int ring_count = 0;
+static _Atomic uint64_t dropped = 0;
+static _Atomic unsigned generation = 0;
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t ring_capacity = EVLOG_DEFAULT_CAPACITY;
+
+static FILE *spill_file = NULL;
+static pthread_t spill_thread;
+static atomic_bool spill_running = false;
+
+static _Thread_local EventRing *local_ring = NULL;
+static _Thread_local unsigned local_generation = 0;
+
+static const char *type_names[EVENT_TYPE_COUNT] = {
+    "compare", "swap", "split", "merge", "dispatch", "grant", "release", "check", "move"
+};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Register a ring for the calling thread on its first event of a session
+static EventRing *acquire_ring(void) {
+    pthread_mutex_lock(&registry_lock);
+    int index = atomic_load(&ring_count);
+    EventRing *ring = NULL;
+    if (index < EVLOG_MAX_THREADS) {
+        ring = (EventRing*)calloc(1, sizeof(EventRing));
+        Event *events = ring ? (Event*)malloc(ring_capacity * sizeof(Event)) : NULL;
+        if (events == NULL) {
+            // The caller counts the event as dropped and retries next time
+            free(ring);
+            pthread_mutex_unlock(&registry_lock);
+            return NULL;
+        }
+        ring->events = events;
+        ring->mask = ring_capacity - 1;
+        ring->thread = (uint16_t)index;
+        rings[index] = ring;
+        atomic_store(&ring_count, index + 1);
+    }
+    pthread_mutex_unlock(&registry_lock);
+
+    local_ring = ring;
+    local_generation = atomic_load(&generation);
+    return ring;
+}
+
+// Copy out everything currently in one ring; returns the number of events
+static size_t drain_ring(EventRing *ring, EventCallback callback, void *context, FILE *file) {
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t count = head - tail;
+
+    while (tail < head) {
+        uint64_t slot = tail & ring->mask;
+        size_t run = ring->mask + 1 - slot;
+        if (run > head - tail) run = head - tail;
+
+        if (file != NULL) {
+            fwrite(&ring->events[slot], sizeof(Event), run, file);
+        } else {
+            for (size_t i = 0; i < run; i++)
+                callback(&ring->events[slot + i], context);
+        }
+        tail += run;
+    }
+
+    atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    return count;
+}
+
+static void *spill_loop(void *arg) {
+    (void)arg;
+    struct timespec pause = {0, 1000000};
+
+    while (atomic_load(&spill_running)) {
+        size_t moved = 0;
+        int count = atomic_load(&ring_count);
+        for (int i = 0; i < count; i++)
+            moved += drain_ring(rings[i], NULL, NULL, spill_file);
+        if (moved == 0)
+            nanosleep(&pause, NULL);
+    }
+    return NULL;
+}
+
+// Begin a recording session. In spill mode producers wait for the writer
+// when their ring is full; in memory mode they drop and count the event.
+bool evlog_start(const EventLogConfig *config) {
+    size_t capacity = config && config->capacity ? config->capacity : EVLOG_DEFAULT_CAPACITY;
+    ring_capacity = 1;
+    while (ring_capacity < capacity) ring_capacity <<= 1;
+
+    if (config && config->spillPath) {
+        spill_file = fopen(config->spillPath, "wb");
+        if (spill_file == NULL) return false;
+
+        EventFileHeader header = {EVLOG_MAGIC, EVLOG_VERSION, sizeof(Event)};
+        fwrite(&header, sizeof(header), 1, spill_file);
+        atomic_store(&spill_running, true);
+        pthread_create(&spill_thread, NULL, spill_loop, NULL);
+    }
+
+    atomic_fetch_add(&generation, 1);
+    atomic_store(&dropped, 0);
+    atomic_store(&evlog_active, true);
+    return true;
+}
+
+// Start spilling to $EVLOG_PATH when it is set (used by the demo mains)
+bool evlog_start_from_env(void) {
+    const char *path = getenv("EVLOG_PATH");
+    if (path == NULL || path[0] == '\0') return false;
+
+    EventLogConfig config = {0, path};
+    return evlog_start(&config);
+}
+
+// End the session, flushing the spill file. Must not race with emitters;
+// in memory mode, drain before stopping since the rings are released here.
+void evlog_stop(void) {
+    atomic_store(&evlog_active, false);
+
+    if (spill_file != NULL) {
+        atomic_store(&spill_running, false);
+        pthread_join(spill_thread, NULL);
+        int count = atomic_load(&ring_count);
+        for (int i = 0; i < count; i++)
+            drain_ring(rings[i], NULL, NULL, spill_file);
+        fclose(spill_file);
+        spill_file = NULL;
+    }
+
+    pthread_mutex_lock(&registry_lock);
+    int count = atomic_load(&ring_count);
+    for (int i = 0; i < count; i++) {
+        free(rings[i]->events);
+        free(rings[i]);
+        rings[i] = NULL;
+    }
+    atomic_store(&ring_count, 0);
+    pthread_mutex_unlock(&registry_lock);
+}
+
+void evlog_emit(EventEngine engine, EventType type, int32_t a, int32_t b, int32_t c) {
+    EventRing *ring = local_ring;
+    if (ring == NULL || local_generation != atomic_load_explicit(&generation, memory_order_relaxed)) {
+        ring = acquire_ring();
+        if (ring == NULL) {
+            atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+            return;
+        }
+    }
+
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    while (head - atomic_load_explicit(&ring->tail, memory_order_acquire) > ring->mask) {
+        if (!atomic_load_explicit(&spill_running, memory_order_relaxed)) {
+            atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+            return;
+        }
+        sched_yield();
+    }
+
+    Event *event = &ring->events[head & ring->mask];
+    event->timestamp = now_ns();
+    event->type = (uint8_t)type;
+    event->engine = (uint8_t)engine;
+    event->thread = ring->thread;
+    event->a = a;
+    event->b = b;
+    event->c = c;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+// Consume buffered events from every thread (memory mode); one consumer at a time
+size_t evlog_drain(EventCallback callback, void *context) {
+    size_t total = 0;
+    int count = atomic_load(&ring_count);
+    for (int i = 0; i < count; i++)
+        total += drain_ring(rings[i], callback, context, NULL);
+    return total;
+}
+
+uint64_t evlog_dropped(void) {
+    return atomic_load(&dropped);
+}
+
+// Consecutive events from one thread in a spill file
+typedef struct {
+    uint64_t first;   // index of the first event after the header
+    uint64_t count;
+} SpillRun;
+
+#define REPLAY_BUFFER 1024
+
+// Reads one thread's events back in order by walking its runs
+typedef struct {
+    SpillRun *runs;
+    size_t runCount;
+    size_t runCapacity;
+    size_t run;
+    uint64_t offset;           // events consumed from runs[run]
+    Event buffer[REPLAY_BUFFER];
+    size_t buffered;
+    size_t position;
+} ReplayCursor;
+
+static bool add_run(ReplayCursor *cursor, uint64_t first) {
+    if (cursor->runCount > 0) {
+        SpillRun *last = &cursor->runs[cursor->runCount - 1];
+        if (last->first + last->count == first) {
+            last->count++;
+            return true;
+        }
+    }
+    if (cursor->runCount == cursor->runCapacity) {
+        size_t capacity = cursor->runCapacity ? cursor->runCapacity * 2 : 64;
+        SpillRun *runs = (SpillRun*)realloc(cursor->runs, capacity * sizeof(SpillRun));
+        if (runs == NULL) return false;
+        cursor->runs = runs;
+        cursor->runCapacity = capacity;
+    }
+    cursor->runs[cursor->runCount++] = (SpillRun){first, 1};
+    return true;
+}
+
+// Current event of a cursor, refilling its buffer from the file; NULL at the end
+static const Event *cursor_peek(ReplayCursor *cursor, FILE *file, bool *ok) {
+    if (cursor->position < cursor->buffered)
+        return &cursor->buffer[cursor->position];
+
+    while (cursor->run < cursor->runCount && cursor->offset == cursor->runs[cursor->run].count) {
+        cursor->run++;
+        cursor->offset = 0;
+    }
+    if (cursor->run == cursor->runCount) return NULL;
+
+    SpillRun *run = &cursor->runs[cursor->run];
+    size_t want = run->count - cursor->offset < REPLAY_BUFFER ? (size_t)(run->count - cursor->offset) : REPLAY_BUFFER;
+    off_t at = (off_t)sizeof(EventFileHeader) + (off_t)((run->first + cursor->offset) * sizeof(Event));
+    if (fseeko(file, at, SEEK_SET) != 0 || fread(cursor->buffer, sizeof(Event), want, file) != want) {
+        *ok = false;
+        return NULL;
+    }
+    cursor->offset += want;
+    cursor->buffered = want;
+    cursor->position = 0;
+    return &cursor->buffer[0];
+}
+
+static bool cursor_before(ReplayCursor **cursors, FILE *file, int a, int b, bool *ok) {
+    const Event *x = cursor_peek(cursors[a], file, ok);
+    const Event *y = cursor_peek(cursors[b], file, ok);
+    if (x == NULL || y == NULL) return false;
+    return x->timestamp < y->timestamp || (x->timestamp == y->timestamp && x->thread < y->thread);
+}
+
+static void heap_sift_down(int *heap, int size, int at, ReplayCursor **cursors, FILE *file, bool *ok) {
+    while (1) {
+        int smallest = at;
+        int left = 2 * at + 1;
+        int right = left + 1;
+        if (left < size && cursor_before(cursors, file, heap[left], heap[smallest], ok)) smallest = left;
+        if (right < size && cursor_before(cursors, file, heap[right], heap[smallest], ok)) smallest = right;
+        if (smallest == at) return;
+        int temp = heap[at];
+        heap[at] = heap[smallest];
+        heap[smallest] = temp;
+        at = smallest;
+    }
+}
+
+// Stream a spill file through callback in timestamp order, applying the type
+// mask and stride. The file holds per-thread batches in drain order; a first
+// pass indexes each thread's runs, then a heap merges the threads, whose own
+// events are already in order. Ties break by thread.
+bool evlog_replay(const char *path, const EventFilter *filter, EventCallback callback, void *context) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return false;
+
+    EventFileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != EVLOG_MAGIC ||
+        header.version != EVLOG_VERSION || header.eventSize != sizeof(Event)) {
+        fclose(file);
+        return false;
+    }
+
+    ReplayCursor *cursors[EVLOG_MAX_THREADS] = {NULL};
+    int heap[EVLOG_MAX_THREADS];
+    int heapSize = 0;
+    bool ok = true;
+
+    Event batch[4096];
+    size_t got;
+    uint64_t index = 0;
+    while (ok && (got = fread(batch, sizeof(Event), 4096, file)) > 0) {
+        for (size_t i = 0; i < got && ok; i++, index++) {
+            uint16_t thread = batch[i].thread;
+            if (thread >= EVLOG_MAX_THREADS) {
+                ok = false;
+                break;
+            }
+            if (cursors[thread] == NULL) {
+                cursors[thread] = (ReplayCursor*)calloc(1, sizeof(ReplayCursor));
+                if (cursors[thread] == NULL) {
+                    ok = false;
+                    break;
+                }
+                heap[heapSize++] = thread;
+            }
+            ok = add_run(cursors[thread], index);
+        }
+    }
+
+    for (int i = heapSize / 2 - 1; ok && i >= 0; i--)
+        heap_sift_down(heap, heapSize, i, cursors, file, &ok);
+
+    uint32_t mask = filter && filter->typeMask ? filter->typeMask : ~0u;
+    uint32_t stride = filter && filter->stride > 1 ? filter->stride : 1;
+    uint64_t matched = 0;
+
+    while (ok && heapSize > 0) {
+        ReplayCursor *cursor = cursors[heap[0]];
+        const Event *event = cursor_peek(cursor, file, &ok);
+        if (event == NULL) break;
+        if ((mask & (1u << event->type)) && matched++ % stride == 0)
+            callback(event, context);
+
+        cursor->position++;
+        if (cursor_peek(cursor, file, &ok) == NULL)
+            heap[0] = heap[--heapSize];
+        heap_sift_down(heap, heapSize, 0, cursors, file, &ok);
+    }
+
+    for (int t = 0; t < EVLOG_MAX_THREADS; t++) {
+        if (cursors[t] != NULL) {
+            free(cursors[t]->runs);
+            free(cursors[t]);
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+const char *evlog_type_name(EventType type) {
+    return type < EVENT_TYPE_COUNT ? type_names[type] : "unknown";
+}
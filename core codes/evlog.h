@@ -0,0 +1,110 @@
+#ifndef EVLOG_H
+#define EVLOG_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary step-event log shared by the engines.
+//
+// Engines record fixed-size events through the EVLOG() macro. Each thread
+// writes to its own single-producer ring buffer, so recording takes no locks.
+// Events either stay in memory until evlog_drain() reads them, thread by
+// thread, or a background thread spills them to a file that evlog_replay()
+// reads back merged into timestamp order.
+//
+// Build with -DEVLOG_ENABLED (and link evlog.c with -pthread) to compile the
+// probes in. Without it, EVLOG() expands to nothing. With it, a disabled log
+// costs one predictable branch per probe.
+//
+// The integer sorts log every comparison as a COMPARE (partition scans name
+// the pivot's current index) and every write to the array as a SWAP or MOVE,
+// so applying the events in replay order to a copy of the input rebuilds each
+// intermediate state and the sorted result. The key/index sorts behind
+// sortRecords() are not traced.
+
+#define EVLOG_MAGIC 0x474C5645u  // "EVLG"
+#define EVLOG_VERSION 1
+#define EVLOG_MAX_THREADS 256
+#define EVLOG_DEFAULT_CAPACITY (1u << 16)
+
+typedef enum {
+    ENGINE_MSV,
+    ENGINE_PSV,
+    ENGINE_MAS,
+    ENGINE_DEAD,
+    ENGINE_SIM
+} EventEngine;
+
+typedef enum {
+    EVENT_COMPARE,   // a, b: indices compared
+    EVENT_SWAP,      // a, b: indices exchanged
+    EVENT_SPLIT,     // a..c: range split (low, split, high) or block split (block, start, size)
+    EVENT_MERGE,     // a..c: ranges merged (left, mid, right) or blocks merged (block, start, size)
+    EVENT_DISPATCH,  // a: process id, b: start time, c: duration
+    EVENT_GRANT,     // a: process/block, b: resource/start, c: amount/size
+    EVENT_RELEASE,   // a: process/block, b: resource/start, c: amount/size
+    EVENT_CHECK,     // a: process index (-1 for the verdict), b: sequence position, c: safe
+    EVENT_MOVE,      // a: index written, b: value written
+    EVENT_TYPE_COUNT
+} EventType;
+
+// 24-byte record; timestamps are CLOCK_MONOTONIC nanoseconds
+typedef struct {
+    uint64_t timestamp;
+    uint8_t type;
+    uint8_t engine;
+    uint16_t thread;
+    int32_t a;
+    int32_t b;
+    int32_t c;
+} Event;
+
+// Spill file header, followed by Event records in per-thread batches
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t eventSize;
+} EventFileHeader;
+
+typedef struct {
+    size_t capacity;         // events per thread ring, rounded up to a power of two
+    const char *spillPath;   // NULL keeps events in memory for evlog_drain()
+} EventLogConfig;
+
+// Replay filter: typeMask selects types by bit (0 keeps all); stride keeps
+// every stride-th matching event (0 or 1 keeps all)
+typedef struct {
+    uint32_t typeMask;
+    uint32_t stride;
+} EventFilter;
+
+typedef void (*EventCallback)(const Event *event, void *context);
+
+extern atomic_bool evlog_active;
+
+bool evlog_start(const EventLogConfig *config);
+bool evlog_start_from_env(void);
+void evlog_stop(void);
+void evlog_emit(EventEngine engine, EventType type, int32_t a, int32_t b, int32_t c);
+size_t evlog_drain(EventCallback callback, void *context);
+uint64_t evlog_dropped(void);
+bool evlog_replay(const char *path, const EventFilter *filter, EventCallback callback, void *context);
+const char *evlog_type_name(EventType type);
+
+#ifdef EVLOG_ENABLED
+#define EVLOG(engine, type, a, b, c) \
+    do { \
+        if (atomic_load_explicit(&evlog_active, memory_order_relaxed)) \
+            evlog_emit((engine), (type), (a), (b), (c)); \
+    } while (0)
+#define EVLOG_START_FROM_ENV() evlog_start_from_env()
+#define EVLOG_STOP() evlog_stop()
+#else
+#define EVLOG(engine, type, a, b, c) ((void)0)
+#define EVLOG_START_FROM_ENV() ((void)0)
+#define EVLOG_STOP() ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "evlog.h"
+
+// Replays an event spill file as CSV, or summarizes it.
+// Usage: evlog_dump <file> [--types swap,compare] [--stride N] [--summary]
+
+static const char *engine_names[] = {"msv", "psv", "mas", "dead", "sim"};
+#define ENGINE_COUNT ((int)(sizeof(engine_names) / sizeof(engine_names[0])))
+
+typedef struct {
+    unsigned long long counts[ENGINE_COUNT][EVENT_TYPE_COUNT];
+    unsigned long long total;
+    uint64_t first;
+    uint64_t last;
+} Summary;
+
+static void print_event(const Event *event, void *context) {
+    (void)context;
+    printf("%llu,%u,%s,%s,%d,%d,%d\n",
+           (unsigned long long)event->timestamp, event->thread,
+           event->engine < ENGINE_COUNT ? engine_names[event->engine] : "unknown",
+           evlog_type_name((EventType)event->type), event->a, event->b, event->c);
+}
+
+static void summarize_event(const Event *event, void *context) {
+    Summary *summary = (Summary*)context;
+    if (event->engine < ENGINE_COUNT && event->type < EVENT_TYPE_COUNT)
+        summary->counts[event->engine][event->type]++;
+    if (summary->total == 0 || event->timestamp < summary->first) summary->first = event->timestamp;
+    if (event->timestamp > summary->last) summary->last = event->timestamp;
+    summary->total++;
+}
+
+static uint32_t parse_types(const char *text) {
+    char buffer[256];
+    uint32_t mask = 0;
+    snprintf(buffer, sizeof(buffer), "%s", text);
+
+    for (char *token = strtok(buffer, ","); token; token = strtok(NULL, ",")) {
+        for (int t = 0; t < EVENT_TYPE_COUNT; t++) {
+            if (strcmp(token, evlog_type_name((EventType)t)) == 0) mask |= 1u << t;
+        }
+    }
+    return mask;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <file> [--types a,b] [--stride N] [--summary]\n", argv[0]);
+        return 2;
+    }
+
+    EventFilter filter = {0, 1};
+    int summary_only = 0;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--types") == 0 && i + 1 < argc)
+            filter.typeMask = parse_types(argv[++i]);
+        else if (strcmp(argv[i], "--stride") == 0 && i + 1 < argc)
+            filter.stride = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--summary") == 0)
+            summary_only = 1;
+    }
+
+    if (summary_only) {
+        Summary summary;
+        memset(&summary, 0, sizeof(summary));
+        if (!evlog_replay(argv[1], &filter, summarize_event, &summary)) {
+            fprintf(stderr, "Cannot read event log %s\n", argv[1]);
+            return 1;
+        }
+
+        printf("Events: %llu over %.3f ms\n", summary.total,
+               summary.total ? (summary.last - summary.first) / 1e6 : 0.0);
+        for (int e = 0; e < ENGINE_COUNT; e++) {
+            for (int t = 0; t < EVENT_TYPE_COUNT; t++) {
+                if (summary.counts[e][t] > 0)
+                    printf("  %-5s %-9s %llu\n", engine_names[e], evlog_type_name((EventType)t), summary.counts[e][t]);
+            }
+        }
+        return 0;
+    }
+
+    printf("timestamp_ns,thread,engine,type,a,b,c\n");
+    if (!evlog_replay(argv[1], &filter, print_event, NULL)) {
+        fprintf(stderr, "Cannot read event log %s\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}
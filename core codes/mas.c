@@ -3,63 +3,17 @@
 #include <string.h>
 #include <stdbool.h>
 #include <time.h>
-
-#define MAX_BLOCKS 1024
-#define MAX_PROCESSES 1024
-#define MAX_NAME_LENGTH 64
-
-typedef enum {
-    FIRST_FIT,
-    BEST_FIT,
-    WORST_FIT,
-    NEXT_FIT
-} AllocationStrategy;
-
-typedef struct {
-    char id[32];
-    char name[MAX_NAME_LENGTH];
-    int size;
-    int start_time;
-    int allocated_at;
-    int deallocated_at;
-} Process;
-
-typedef struct {
-    char id[32];
-    int start;
-    int end;
-    int size;
-    bool is_free;
-    Process* process;
-} MemoryBlock;
-
-typedef struct {
-    MemoryBlock blocks[MAX_BLOCKS];
-    int block_count;
-    int total_memory;
-    int next_fit_pointer;
-    AllocationStrategy strategy;
-    Process processes[MAX_PROCESSES];
-    int process_count;
-    double fragmentation;
-    int current_time;
-} MemoryManager;
-
-// Function prototypes
-void init_memory_manager(MemoryManager* manager, int total_memory);
-char* generate_random_id(char* buffer);
-int find_suitable_block(MemoryManager* manager, int size);
-bool allocate_memory(MemoryManager* manager, Process* process);
-void deallocate_process(MemoryManager* manager, const char* process_id);
-void merge_free_blocks(MemoryManager* manager);
-void calculate_fragmentation(MemoryManager* manager);
-void print_memory_state(MemoryManager* manager);
+#include "mas.h"
+#include "evlog.h"
+#include "probe.h"
+#include "workload.h"
 
 // Initialize memory manager
 void init_memory_manager(MemoryManager* manager, int total_memory) {
     manager->total_memory = total_memory;
     manager->block_count = 1;
     manager->process_count = 0;
+    manager->free_slot_count = 0;
     manager->next_fit_pointer = 0;
     manager->strategy = BEST_FIT;
     manager->current_time = 0;
@@ -71,7 +25,7 @@ void init_memory_manager(MemoryManager* manager, int total_memory) {
     manager->blocks[0].end = total_memory;
     manager->blocks[0].size = total_memory;
     manager->blocks[0].is_free = true;
-    manager->blocks[0].process = NULL;
+    manager->blocks[0].process_index = -1;
 }
 
 // Generate random ID
@@ -89,11 +43,14 @@ char* generate_random_id(char* buffer) {
 
 // Find suitable block based on strategy
 int find_suitable_block(MemoryManager* manager, int size) {
+    PROBE_SCOPE(PROBE_TIMER_FIND_BLOCK);
+    PROBE_COUNT(PROBE_MAS_FIND_CALLS, 1);
     int selected_block = -1;
 
     switch (manager->strategy) {
         case FIRST_FIT:
             for (int i = 0; i < manager->block_count; i++) {
+                PROBE_COUNT(PROBE_MAS_BLOCKS_SCANNED, 1);
                 if (manager->blocks[i].is_free && manager->blocks[i].size >= size) {
                     selected_block = i;
                     break;
@@ -104,6 +61,7 @@ int find_suitable_block(MemoryManager* manager, int size) {
         case BEST_FIT: {
             int min_suitable_size = manager->total_memory + 1;
             for (int i = 0; i < manager->block_count; i++) {
+                PROBE_COUNT(PROBE_MAS_BLOCKS_SCANNED, 1);
                 if (manager->blocks[i].is_free && manager->blocks[i].size >= size) {
                     if (manager->blocks[i].size < min_suitable_size) {
                         min_suitable_size = manager->blocks[i].size;
@@ -117,6 +75,7 @@ int find_suitable_block(MemoryManager* manager, int size) {
         case WORST_FIT: {
             int max_suitable_size = -1;
             for (int i = 0; i < manager->block_count; i++) {
+                PROBE_COUNT(PROBE_MAS_BLOCKS_SCANNED, 1);
                 if (manager->blocks[i].is_free && manager->blocks[i].size >= size) {
                     if (manager->blocks[i].size > max_suitable_size) {
                         max_suitable_size = manager->blocks[i].size;
@@ -131,6 +90,7 @@ int find_suitable_block(MemoryManager* manager, int size) {
             int start_point = manager->next_fit_pointer;
             for (int i = 0; i < manager->block_count; i++) {
                 int index = (start_point + i) % manager->block_count;
+                PROBE_COUNT(PROBE_MAS_BLOCKS_SCANNED, 1);
                 if (manager->blocks[index].is_free && manager->blocks[index].size >= size) {
                     selected_block = index;
                     manager->next_fit_pointer = (index + 1) % manager->block_count;
@@ -152,10 +112,17 @@ bool allocate_memory(MemoryManager* manager, Process* process) {
         return false;
     }
 
+    // Fail rather than overflow the block or process tables
+    bool needs_split = manager->blocks[block_index].size > process->size;
+    if ((needs_split && manager->block_count >= MAX_BLOCKS) ||
+        (manager->free_slot_count == 0 && manager->process_count >= MAX_PROCESSES)) {
+        return false;
+    }
+
     MemoryBlock* selected_block = &manager->blocks[block_index];
 
     // Split block if necessary
-    if (selected_block->size > process->size) {
+    if (needs_split) {
         // Create new free block
         MemoryBlock new_block;
         generate_random_id(new_block.id);
@@ -163,7 +130,7 @@ bool allocate_memory(MemoryManager* manager, Process* process) {
         new_block.end = selected_block->end;
         new_block.size = selected_block->size - process->size;
         new_block.is_free = true;
-        new_block.process = NULL;
+        new_block.process_index = -1;
 
         // Update selected block
         selected_block->end = selected_block->start + process->size;
@@ -175,35 +142,68 @@ bool allocate_memory(MemoryManager* manager, Process* process) {
         }
         manager->blocks[block_index + 1] = new_block;
         manager->block_count++;
+        EVLOG(ENGINE_MAS, EVENT_SPLIT, block_index, new_block.start, new_block.size);
     }
 
+    // Add process to process list, reusing a released slot if there is one
+    int slot = manager->free_slot_count > 0 ?
+        manager->free_slots[--manager->free_slot_count] : manager->process_count++;
+    process->allocated_at = manager->current_time;
+    manager->processes[slot] = *process;
+
     // Update selected block with process
     selected_block->is_free = false;
-    selected_block->process = process;
-    process->allocated_at = manager->current_time;
-    
-    // Add process to process list
-    manager->processes[manager->process_count++] = *process;
+    selected_block->process_index = slot;
+    EVLOG(ENGINE_MAS, EVENT_GRANT, block_index, selected_block->start, selected_block->size);
     
     calculate_fragmentation(manager);
     return true;
 }
 
+// Find the process table slot of an allocated process, or -1
+int find_process_slot(MemoryManager* manager, const char* process_id) {
+    for (int i = 0; i < manager->block_count; i++) {
+        int slot = manager->blocks[i].process_index;
+        if (!manager->blocks[i].is_free && slot >= 0 &&
+            strcmp(manager->processes[slot].id, process_id) == 0) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
 // Deallocate process
 void deallocate_process(MemoryManager* manager, const char* process_id) {
     for (int i = 0; i < manager->block_count; i++) {
+        int slot = manager->blocks[i].process_index;
         if (!manager->blocks[i].is_free && 
-            manager->blocks[i].process != NULL && 
-            strcmp(manager->blocks[i].process->id, process_id) == 0) {
+            slot >= 0 && 
+            strcmp(manager->processes[slot].id, process_id) == 0) {
             
             manager->blocks[i].is_free = true;
-            manager->blocks[i].process->deallocated_at = manager->current_time;
-            manager->blocks[i].process = NULL;
+            EVLOG(ENGINE_MAS, EVENT_RELEASE, i, manager->blocks[i].start, manager->blocks[i].size);
+            manager->processes[slot].deallocated_at = manager->current_time;
+            manager->processes[slot].id[0] = '\0';
+            manager->free_slots[manager->free_slot_count++] = slot;
+            manager->blocks[i].process_index = -1;
+
+            // No two free blocks are ever adjacent, so only the freed
+            // block's neighbours can need merging
+            int first = i > 0 && manager->blocks[i - 1].is_free ? i - 1 : i;
+            int last = i + 1 < manager->block_count && manager->blocks[i + 1].is_free ? i + 1 : i;
+            if (last > first) {
+                manager->blocks[first].end = manager->blocks[last].end;
+                manager->blocks[first].size = manager->blocks[first].end - manager->blocks[first].start;
+                EVLOG(ENGINE_MAS, EVENT_MERGE, first, manager->blocks[first].start, manager->blocks[first].size);
+                int removed = last - first;
+                memmove(&manager->blocks[first + 1], &manager->blocks[last + 1],
+                        (manager->block_count - last - 1) * sizeof(MemoryBlock));
+                manager->block_count -= removed;
+            }
             break;
         }
     }
 
-    merge_free_blocks(manager);
     calculate_fragmentation(manager);
 }
 
@@ -215,6 +215,7 @@ void merge_free_blocks(MemoryManager* manager) {
             // Merge blocks
             manager->blocks[i].end = manager->blocks[i + 1].end;
             manager->blocks[i].size += manager->blocks[i + 1].size;
+            EVLOG(ENGINE_MAS, EVENT_MERGE, i, manager->blocks[i].start, manager->blocks[i].size);
 
             // Remove the second block
             for (int j = i + 1; j < manager->block_count - 1; j++) {
@@ -252,7 +253,7 @@ void calculate_fragmentation(MemoryManager* manager) {
 void print_memory_state(MemoryManager* manager) {
     printf("\nMemory State (Total: %d MB):\n", manager->total_memory);
     printf("Fragmentation: %.2f%%\n", manager->fragmentation);
-    printf("Active Processes: %d\n", manager->process_count);
+    printf("Active Processes: %d\n", manager->process_count - manager->free_slot_count);
     
     for (int i = 0; i < manager->block_count; i++) {
         printf("Block %d: [%d-%d] %d MB - %s\n",
@@ -261,16 +262,106 @@ void print_memory_state(MemoryManager* manager) {
             manager->blocks[i].end,
             manager->blocks[i].size,
             manager->blocks[i].is_free ? "Free" : 
-                manager->blocks[i].process ? manager->blocks[i].process->name : "Unknown"
+                manager->blocks[i].process_index >= 0 ?
+                    manager->processes[manager->blocks[i].process_index].name : "Unknown"
         );
     }
 }
 
+#ifndef MAS_NO_MAIN
+// Replay a generated job file as an allocation stream, swapping out the
+// oldest resident process whenever a request doesn't fit:
+// mas --workload FILE [--memory MB] [--strategy first|best|worst|next]
+static int run_workload(int argc, char *argv[]) {
+    int total_memory = 2048;
+    AllocationStrategy strategy = FIRST_FIT;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--memory") == 0) total_memory = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--strategy") == 0) {
+            if (strcmp(argv[i + 1], "best") == 0) strategy = BEST_FIT;
+            else if (strcmp(argv[i + 1], "worst") == 0) strategy = WORST_FIT;
+            else if (strcmp(argv[i + 1], "next") == 0) strategy = NEXT_FIT;
+        }
+    }
+
+    WorkloadFileHeader header;
+    FILE *file = workload_open(argv[2], WORKLOAD_JOBS, &header);
+    if (file == NULL) {
+        fprintf(stderr, "Cannot read job workload %s\n", argv[2]);
+        return 1;
+    }
+
+    MemoryManager *manager = (MemoryManager*)malloc(sizeof(MemoryManager));
+    init_memory_manager(manager, total_memory);
+    manager->strategy = strategy;
+
+    // Resident process ids in allocation order
+    char (*resident)[32] = malloc(MAX_PROCESSES * sizeof(*resident));
+    int head = 0, resident_count = 0;
+    long long allocated = 0, evicted = 0, rejected = 0;
+    double fragmentation_sum = 0.0;
+
+    EVLOG_START_FROM_ENV();
+    PROBE_HW_START();
+
+    WorkloadJob jobs[1024];
+    size_t got;
+    while ((got = fread(jobs, sizeof(WorkloadJob), 1024, file)) > 0) {
+        for (size_t j = 0; j < got; j++) {
+            Process process = {0};
+            snprintf(process.id, sizeof(process.id), "J%d", jobs[j].id);
+            snprintf(process.name, sizeof(process.name), "job-%d", jobs[j].id);
+            process.size = jobs[j].memory;
+            process.start_time = jobs[j].arrival;
+            manager->current_time = jobs[j].arrival;
+
+            bool placed = process.size <= total_memory && allocate_memory(manager, &process);
+            while (!placed && resident_count > 0 && process.size <= total_memory) {
+                deallocate_process(manager, resident[head]);
+                head = (head + 1) % MAX_PROCESSES;
+                resident_count--;
+                evicted++;
+                placed = allocate_memory(manager, &process);
+            }
+
+            if (placed) {
+                strcpy(resident[(head + resident_count) % MAX_PROCESSES], process.id);
+                resident_count++;
+                allocated++;
+            } else {
+                rejected++;
+            }
+            fragmentation_sum += manager->fragmentation;
+        }
+    }
+
+    PROBE_HW_STOP();
+    PROBE_REPORT();
+    EVLOG_STOP();
+    fclose(file);
+
+    printf("Jobs: %llu, allocated: %lld, swapped out: %lld, rejected: %lld\n",
+           (unsigned long long)header.count, allocated, evicted, rejected);
+    printf("Mean fragmentation: %.2f%%, resident at end: %d\n",
+           header.count ? fragmentation_sum / header.count : 0.0, resident_count);
+
+    free(resident);
+    free(manager);
+    return 0;
+}
+
 // Example usage
-int main() {
+int main(int argc, char *argv[]) {
+    if (argc >= 3 && strcmp(argv[1], "--workload") == 0)
+        return run_workload(argc, argv);
+
     MemoryManager manager;
     init_memory_manager(&manager, 2048); // 2048 MB total memory
 
+    // Record step events to $EVLOG_PATH (builds with EVLOG_ENABLED)
+    EVLOG_START_FROM_ENV();
+    PROBE_HW_START();
+
     // Example process creation and allocation
     Process p1 = {0};
     generate_random_id(p1.id);
@@ -288,5 +379,10 @@ int main() {
     deallocate_process(&manager, p1.id);
     print_memory_state(&manager);
 
+    PROBE_HW_STOP();
+    PROBE_REPORT();
+    EVLOG_STOP();
+
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,62 @@
+#ifndef MAS_H
+#define MAS_H
+
+#include <stdbool.h>
+
+#define MAX_BLOCKS 1024
+#define MAX_PROCESSES 1024
+#define MAX_NAME_LENGTH 64
+
+typedef enum {
+    FIRST_FIT,
+    BEST_FIT,
+    WORST_FIT,
+    NEXT_FIT
+} AllocationStrategy;
+
+typedef struct {
+    char id[32];
+    char name[MAX_NAME_LENGTH];
+    int size;
+    int start_time;
+    int allocated_at;
+    int deallocated_at;
+} Process;
+
+typedef struct {
+    char id[32];
+    int start;
+    int end;
+    int size;
+    bool is_free;
+    int process_index;  // slot in MemoryManager.processes, -1 when free
+} MemoryBlock;
+
+// Plain data with no pointers, so a manager can be snapshotted and mapped
+// back at any address
+typedef struct {
+    MemoryBlock blocks[MAX_BLOCKS];
+    int block_count;
+    int total_memory;
+    int next_fit_pointer;
+    AllocationStrategy strategy;
+    Process processes[MAX_PROCESSES];
+    int process_count;                  // slots in use or freed (high-water mark)
+    int free_slots[MAX_PROCESSES];      // released slots, reused before growing
+    int free_slot_count;
+    double fragmentation;
+    int current_time;
+} MemoryManager;
+
+// Function prototypes
+void init_memory_manager(MemoryManager* manager, int total_memory);
+char* generate_random_id(char* buffer);
+int find_suitable_block(MemoryManager* manager, int size);
+bool allocate_memory(MemoryManager* manager, Process* process);
+int find_process_slot(MemoryManager* manager, const char* process_id);
+void deallocate_process(MemoryManager* manager, const char* process_id);
+void merge_free_blocks(MemoryManager* manager);
+void calculate_fragmentation(MemoryManager* manager);
+void print_memory_state(MemoryManager* manager);
+
+#endif
@@ -0,0 +1,77 @@
+#include <stdio.h>
+#include <string.h>
+#include "mas.h"
+#include "wasm.h"
+
+// WebAssembly exports for the memory allocation simulator. Blocks are
+// exposed as a compact array of five ints per block, rebuilt in module
+// memory on request:
+//   mas_blocks() -> block_count x {start, end, size, is_free, process_slot}
+// where process_slot is the handle returned by mas_allocate, or -1.
+
+typedef struct {
+    int start;
+    int end;
+    int size;
+    int is_free;
+    int process_slot;
+} MemoryBlockView;
+
+_Static_assert(sizeof(MemoryBlockView) == 5 * sizeof(int), "MemoryBlockView must be 5 packed ints");
+
+static MemoryManager manager;
+static MemoryBlockView block_views[MAX_BLOCKS];
+static int process_number = 0;
+
+WASM_EXPORT void mas_init(int total_memory, int strategy) {
+    init_memory_manager(&manager, total_memory);
+    manager.strategy = (AllocationStrategy)strategy;
+    process_number = 0;
+}
+
+WASM_EXPORT void mas_set_time(int current_time) {
+    manager.current_time = current_time;
+}
+
+// Allocate size units; returns a process slot handle, or -1 if no block fits
+WASM_EXPORT int mas_allocate(int size) {
+    Process process = {0};
+    generate_random_id(process.id);
+    snprintf(process.name, sizeof(process.name), "P%d", process_number++);
+    process.size = size;
+    process.start_time = manager.current_time;
+
+    if (!allocate_memory(&manager, &process)) {
+        return -1;
+    }
+    return find_process_slot(&manager, process.id);
+}
+
+WASM_EXPORT void mas_deallocate(int slot) {
+    if (slot < 0 || slot >= manager.process_count || manager.processes[slot].id[0] == '\0') {
+        return;
+    }
+    char id[32];
+    strcpy(id, manager.processes[slot].id);
+    deallocate_process(&manager, id);
+}
+
+WASM_EXPORT MemoryBlockView* mas_blocks(void) {
+    for (int i = 0; i < manager.block_count; i++) {
+        MemoryBlock* block = &manager.blocks[i];
+        block_views[i].start = block->start;
+        block_views[i].end = block->end;
+        block_views[i].size = block->size;
+        block_views[i].is_free = block->is_free;
+        block_views[i].process_slot = block->process_index;
+    }
+    return block_views;
+}
+
+WASM_EXPORT int mas_block_count(void) {
+    return manager.block_count;
+}
+
+WASM_EXPORT double mas_fragmentation(void) {
+    return manager.fragmentation;
+}
@@ -1,16 +1,30 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include "msv.h"
+#include "evlog.h"
+#include "probe.h"
+#include "workload.h"
+
+#ifdef _OPENMP
 #include <omp.h>
+#else
+#include <time.h>
+// Serial fallbacks for builds without OpenMP, such as WebAssembly
+static inline int omp_get_max_threads(void) { return 1; }
+static inline int omp_get_num_threads(void) { return 1; }
+static inline int omp_get_thread_num(void) { return 0; }
+static inline int omp_in_parallel(void) { return 0; }
+static inline void omp_set_num_threads(int threads) { (void)threads; }
+static inline double omp_get_wtime(void) { return (double)clock() / CLOCKS_PER_SEC; }
+#endif
 
-// Function declarations
-void parallelQuickSort(int *arr, int low, int high);
-void parallelMergeSort(int *arr, int left, int right);
-void parallelBucketSort(int *arr, int n);
-void merge(int *arr, int left, int mid, int right);
-void quickSort(int *arr, int low, int high);
-int partition(int *arr, int low, int high);
-void swap(int *a, int *b);
-void printArray(int *arr, int n);
+#define INSERTION_CUTOFF 32
+#define TASK_CUTOFF 4096
+#define PARALLEL_CUTOFF 65536
+#define RADIX_BUCKETS 256
 
 // Utility function to swap elements
 void swap(int *a, int *b) {
@@ -19,60 +33,88 @@ void swap(int *a, int *b) {
     *b = temp;
 }
 
+// Integer kernels, traced as ENGINE_MSV events
+#define SORT_TYPE int
+#define SORT_SUFFIX Ints
+#define SORT_KEY(element) ((long long)(element))
+#define SORT_TRACE_COMPARE(a, b) EVLOG(ENGINE_MSV, EVENT_COMPARE, (int32_t)(a), (int32_t)(b), 0)
+#define SORT_TRACE_SWAP(a, b) EVLOG(ENGINE_MSV, EVENT_SWAP, (int32_t)(a), (int32_t)(b), 0)
+#define SORT_TRACE_MOVE(index, element) EVLOG(ENGINE_MSV, EVENT_MOVE, (int32_t)(index), (element), 0)
+#define SORT_TRACE_SPLIT(low, split, high) \
+    EVLOG(ENGINE_MSV, EVENT_SPLIT, (int32_t)(low), (int32_t)(split), (int32_t)(high))
+#include "msv_sort_template.h"
+
+// Key/index kernels for sortRecords(); untraced, since their indices don't
+// name positions in any array the event log describes
+#define SORT_TYPE KeyIndex
+#define SORT_SUFFIX Pairs
+#define SORT_KEY(element) ((element).key)
+#define SORT_TRACE_COMPARE(a, b) ((void)0)
+#define SORT_TRACE_SWAP(a, b) ((void)0)
+#define SORT_TRACE_MOVE(index, element) ((void)0)
+#define SORT_TRACE_SPLIT(low, split, high) ((void)0)
+#include "msv_sort_template.h"
+
+// Sort arr[low..high] with the quicksort kernel
+static void quickSortRange(int *arr, int low, int high, bool spawn) {
+    quickSortInts(arr + low, (size_t)(high - low) + 1, (size_t)low, spawn);
+}
+
 // Parallel Quick Sort Implementation
 void parallelQuickSort(int *arr, int low, int high) {
-    if (low < high) {
-        #pragma omp parallel
+    if (low >= high) return;
+
+    if (omp_in_parallel()) {
+        // Wait for every descendant task before returning to the caller
+        #pragma omp taskgroup
+        quickSortRange(arr, low, high, true);
+    } else {
+        #pragma omp parallel if(high - low > TASK_CUTOFF)
         {
             #pragma omp single nowait
-            {
-                int pivot = partition(arr, low, high);
-                
-                #pragma omp task
-                parallelQuickSort(arr, low, pivot - 1);
-                
-                #pragma omp task
-                parallelQuickSort(arr, pivot + 1, high);
-            }
+            quickSortRange(arr, low, high, true);
         }
     }
 }
 
-int partition(int *arr, int low, int high) {
-    int pivot = arr[high];
-    int i = low - 1;
-    
-    for (int j = low; j < high; j++) {
-        if (arr[j] < pivot) {
-            i++;
-            swap(&arr[i], &arr[j]);
-        }
+// Sort both halves (the left one as a task), then merge them
+static void mergeSortRange(int *arr, int left, int right) {
+    if (right - left <= INSERTION_CUTOFF) {
+        insertionSortInts(arr + left, (size_t)(right - left) + 1, (size_t)left);
+        return;
     }
-    swap(&arr[i + 1], &arr[high]);
-    return (i + 1);
+
+    int mid = left + (right - left) / 2;
+    EVLOG(ENGINE_MSV, EVENT_SPLIT, left, mid, right);
+
+    #pragma omp task if(right - left > TASK_CUTOFF)
+    mergeSortRange(arr, left, mid);
+
+    mergeSortRange(arr, mid + 1, right);
+
+    #pragma omp taskwait
+    merge(arr, left, mid, right);
 }
 
 // Parallel Merge Sort Implementation
 void parallelMergeSort(int *arr, int left, int right) {
-    if (left < right) {
-        int mid = left + (right - left) / 2;
-        
-        #pragma omp parallel sections
+    if (left >= right) return;
+
+    if (omp_in_parallel()) {
+        mergeSortRange(arr, left, right);
+    } else {
+        #pragma omp parallel if(right - left > TASK_CUTOFF)
         {
-            #pragma omp section
-            parallelMergeSort(arr, left, mid);
-            
-            #pragma omp section
-            parallelMergeSort(arr, mid + 1, right);
+            #pragma omp single nowait
+            mergeSortRange(arr, left, right);
         }
-        
-        merge(arr, left, mid, right);
     }
 }
 
 void merge(int *arr, int left, int mid, int right) {
     int leftSize = mid - left + 1;
     int rightSize = right - mid;
+    EVLOG(ENGINE_MSV, EVENT_MERGE, left, mid, right);
     
     int *leftArr = (int*)malloc(leftSize * sizeof(int));
     int *rightArr = (int*)malloc(rightSize * sizeof(int));
@@ -84,89 +126,223 @@ void merge(int *arr, int left, int mid, int right) {
     
     int i = 0, j = 0, k = left;
     
+    // Comparisons name positions as they were when the merge began; the
+    // values come from the copies, so each write logs the value it stores
     while (i < leftSize && j < rightSize) {
-        if (leftArr[i] <= rightArr[j])
-            arr[k++] = leftArr[i++];
-        else
-            arr[k++] = rightArr[j++];
+        EVLOG(ENGINE_MSV, EVENT_COMPARE, left + i, mid + 1 + j, 0);
+        int value = leftArr[i] <= rightArr[j] ? leftArr[i++] : rightArr[j++];
+        EVLOG(ENGINE_MSV, EVENT_MOVE, k, value, 0);
+        arr[k++] = value;
     }
+    PROBE_COUNT(PROBE_MSV_COMPARISONS, i + j);
     
-    while (i < leftSize)
+    while (i < leftSize) {
+        EVLOG(ENGINE_MSV, EVENT_MOVE, k, leftArr[i], 0);
         arr[k++] = leftArr[i++];
+    }
     
-    while (j < rightSize)
+    while (j < rightSize) {
+        EVLOG(ENGINE_MSV, EVENT_MOVE, k, rightArr[j], 0);
         arr[k++] = rightArr[j++];
+    }
     
     free(leftArr);
     free(rightArr);
 }
 
-// Parallel Bucket Sort Implementation
-void parallelBucketSort(int *arr, int n) {
-    #pragma omp parallel
+// Parallel Bucket Sort Implementation.
+// Buckets split the observed [min, max] range evenly; each thread counts its
+// slice per bucket so the scatter needs no atomics, then buckets are sorted
+// independently and copied back in order. Returns false, leaving arr
+// unchanged, if the scratch buffers can't be allocated.
+bool parallelBucketSort(int *arr, int n) {
+    if (n < 2) return true;
+
+    int minValue = arr[0];
+    int maxValue = arr[0];
+
+    #pragma omp parallel for reduction(min:minValue) reduction(max:maxValue) if(n > PARALLEL_CUTOFF)
+    for (int i = 0; i < n; i++) {
+        if (arr[i] < minValue) minValue = arr[i];
+        if (arr[i] > maxValue) maxValue = arr[i];
+    }
+    PROBE_COUNT(PROBE_MSV_COMPARISONS, 2LL * n);
+    if (minValue == maxValue) return true;
+
+    unsigned long long range = (unsigned long long)((long long)maxValue - minValue) + 1;
+    int maxThreads = omp_get_max_threads();
+    int bucketCount = maxThreads * 8;
+    int *buckets = (int*)malloc(n * sizeof(int));
+    int *bucketStarts = (int*)malloc((bucketCount + 1) * sizeof(int));
+    int *counts = (int*)malloc(maxThreads * bucketCount * sizeof(int));
+    if (buckets == NULL || bucketStarts == NULL || counts == NULL) {
+        free(buckets);
+        free(bucketStarts);
+        free(counts);
+        return false;
+    }
+
+    #pragma omp parallel if(n > PARALLEL_CUTOFF)
     {
-        // Determine number of buckets and local bucket size
+        int thread = omp_get_thread_num();
         int threadCount = omp_get_num_threads();
-        int bucketCount = threadCount;
-        int *bucketSizes = (int*)calloc(bucketCount, sizeof(int));
-        
-        // Distribute elements across buckets
-        #pragma omp for
-        for (int i = 0; i < n; i++) {
-            int bucketIndex = arr[i] * bucketCount / (100 + 1);
-            bucketSizes[bucketIndex]++;
-        }
-        
-        // Allocate bucket memory
-        int **buckets = (int**)malloc(bucketCount * sizeof(int*));
-        int *bucketIndices = (int*)calloc(bucketCount, sizeof(int));
-        
-        for (int i = 0; i < bucketCount; i++) {
-            buckets[i] = (int*)malloc(bucketSizes[i] * sizeof(int));
-        }
-        
-        // Distribute elements into buckets
-        #pragma omp for
-        for (int i = 0; i < n; i++) {
-            int bucketIndex = arr[i] * bucketCount / (100 + 1);
-            int localIndex;
-            
-            #pragma omp atomic capture
-            localIndex = bucketIndices[bucketIndex]++;
-            
-            buckets[bucketIndex][localIndex] = arr[i];
-        }
-        
-        // Sort individual buckets
-        #pragma omp for
-        for (int i = 0; i < bucketCount; i++) {
-            quickSort(buckets[i], 0, bucketSizes[i] - 1);
+        int *localCounts = &counts[thread * bucketCount];
+        int begin = (int)((long long)n * thread / threadCount);
+        int end = (int)((long long)n * (thread + 1) / threadCount);
+
+        // Count elements per bucket for this thread's slice
+        memset(localCounts, 0, bucketCount * sizeof(int));
+        for (int i = begin; i < end; i++) {
+            int bucketIndex = (int)((unsigned long long)((long long)arr[i] - minValue) * bucketCount / range);
+            localCounts[bucketIndex]++;
         }
-        
-        // Merge buckets back into original array
+
+        #pragma omp barrier
         #pragma omp single
         {
-            int index = 0;
-            for (int i = 0; i < bucketCount; i++) {
-                for (int j = 0; j < bucketSizes[i]; j++) {
-                    arr[index++] = buckets[i][j];
+            int offset = 0;
+            for (int b = 0; b < bucketCount; b++) {
+                bucketStarts[b] = offset;
+                for (int t = 0; t < threadCount; t++) {
+                    int count = counts[t * bucketCount + b];
+                    counts[t * bucketCount + b] = offset;
+                    offset += count;
                 }
-                free(buckets[i]);
             }
-            free(buckets);
-            free(bucketSizes);
-            free(bucketIndices);
+            bucketStarts[bucketCount] = offset;
+        }
+
+        // Distribute elements into buckets. Bucket positions match their
+        // final array positions, so the moves and the bucket sorts' swaps
+        // replay onto the array and the copy back is a no-op in the log.
+        for (int i = begin; i < end; i++) {
+            int bucketIndex = (int)((unsigned long long)((long long)arr[i] - minValue) * bucketCount / range);
+            int position = localCounts[bucketIndex]++;
+            EVLOG(ENGINE_MSV, EVENT_MOVE, position, arr[i], 0);
+            buckets[position] = arr[i];
+        }
+
+        #pragma omp barrier
+
+        // Sort individual buckets and copy them back into place
+        #pragma omp for schedule(dynamic, 1)
+        for (int b = 0; b < bucketCount; b++) {
+            quickSort(buckets, bucketStarts[b], bucketStarts[b + 1] - 1);
+            memcpy(&arr[bucketStarts[b]], &buckets[bucketStarts[b]],
+                   (bucketStarts[b + 1] - bucketStarts[b]) * sizeof(int));
         }
     }
+
+    free(buckets);
+    free(bucketStarts);
+    free(counts);
+    return true;
 }
 
 // Helper function for bucket sort
 void quickSort(int *arr, int low, int high) {
-    if (low < high) {
-        int pivot = partition(arr, low, high);
-        quickSort(arr, low, pivot - 1);
-        quickSort(arr, pivot + 1, high);
+    if (low < high)
+        quickSortRange(arr, low, high, false);
+}
+
+// Parallel LSD Radix Sort Implementation (8-bit digits, stable).
+// Returns false, leaving arr unchanged, if the scratch buffers can't be allocated.
+bool parallelRadixSort(int *arr, int n) {
+    if (n < 2) return true;
+
+    // Offsetting by INT_MIN maps keys onto 0..UINT32_MAX in order
+    return radixSortInts(arr, n, (unsigned long long)(long long)INT_MIN, UINT32_MAX);
+}
+
+// Stable radix sort of key/index pairs, only over the bytes the keys span
+static bool radixSortKeyIndex(KeyIndex *pairs, size_t n) {
+    long long minKey = pairs[0].key;
+    long long maxKey = pairs[0].key;
+
+    #pragma omp parallel for reduction(min:minKey) reduction(max:maxKey) if(n > PARALLEL_CUTOFF)
+    for (size_t i = 0; i < n; i++) {
+        if (pairs[i].key < minKey) minKey = pairs[i].key;
+        if (pairs[i].key > maxKey) maxKey = pairs[i].key;
     }
+    PROBE_COUNT(PROBE_MSV_COMPARISONS, 2 * n);
+
+    unsigned long long range = (unsigned long long)maxKey - (unsigned long long)minKey;
+    if (range == 0) return true;
+    return radixSortPairs(pairs, n, (unsigned long long)minKey, range);
+}
+
+// Sort key/index pairs by key; the stable variant preserves input order of equal keys
+bool sortKeyIndex(KeyIndex *pairs, size_t n, bool stable) {
+    if (n <= INSERTION_CUTOFF) {
+        insertionSortPairs(pairs, n, 0);
+        return true;
+    }
+
+    if (stable)
+        return radixSortKeyIndex(pairs, n);
+
+    if (omp_in_parallel()) {
+        // Wait for every descendant task before returning to the caller
+        #pragma omp taskgroup
+        quickSortPairs(pairs, n, 0, true);
+    } else {
+        #pragma omp parallel if(n > TASK_CUTOFF)
+        {
+            #pragma omp single nowait
+            quickSortPairs(pairs, n, 0, true);
+        }
+    }
+    return true;
+}
+
+// Move records into sorted order, following each permutation cycle once.
+// pairs[i].index names the record that belongs at position i; the indices
+// are consumed in the process. Returns false, moving nothing, if the
+// one-record scratch buffer can't be allocated.
+bool applyPermutation(void *base, size_t n, size_t size, KeyIndex *pairs) {
+    char *records = (char*)base;
+    char *held = (char*)malloc(size);
+    if (held == NULL) return false;
+
+    for (size_t i = 0; i < n; i++) {
+        if (pairs[i].index == i) continue;
+
+        memcpy(held, records + i * size, size);
+        size_t j = i;
+        while (1) {
+            size_t source = pairs[j].index;
+            pairs[j].index = j;
+            if (source == i) {
+                memcpy(records + j * size, held, size);
+                break;
+            }
+            memcpy(records + j * size, records + source * size, size);
+            j = source;
+        }
+    }
+
+    free(held);
+    return true;
+}
+
+// Sort an array of records of the given size by an extracted integer key
+bool sortRecords(void *base, size_t n, size_t size, SortKeyFn key, bool stable) {
+    if (n < 2) return true;
+
+    KeyIndex *pairs = (KeyIndex*)malloc(n * sizeof(KeyIndex));
+    if (pairs == NULL) return false;
+
+    const char *records = (const char*)base;
+    #pragma omp parallel for if(n > PARALLEL_CUTOFF)
+    for (size_t i = 0; i < n; i++) {
+        pairs[i].key = key(records + i * size);
+        pairs[i].index = i;
+    }
+
+    bool sorted = sortKeyIndex(pairs, n, stable) && applyPermutation(base, n, size, pairs);
+
+    free(pairs);
+    return sorted;
 }
 
 // Utility function to print array
@@ -176,8 +352,66 @@ void printArray(int *arr, int n) {
     printf("\n");
 }
 
-// Main function with example usage
-int main() {
+#ifndef MSV_NO_MAIN
+// Main function with example usage.
+// Usage: msv --external <input> <output> [--memory-mb N] [--tmp-dir DIR]
+int main(int argc, char *argv[]) {
+    if (argc >= 4 && strcmp(argv[1], "--external") == 0) {
+        ExternalSortOptions options = {0};
+        for (int i = 4; i + 1 < argc; i += 2) {
+            if (strcmp(argv[i], "--memory-mb") == 0)
+                options.memoryBudget = strtoul(argv[i + 1], NULL, 10) << 20;
+            else if (strcmp(argv[i], "--tmp-dir") == 0)
+                options.tempDir = argv[i + 1];
+        }
+
+        if (!externalSort(argv[2], argv[3], &options)) {
+            perror("External sort failed");
+            return 1;
+        }
+        return 0;
+    }
+
+    // Sort a generated int file: msv --workload FILE [--algorithm quick|merge|bucket|radix]
+    if (argc >= 3 && strcmp(argv[1], "--workload") == 0) {
+        const char *algorithm = argc >= 5 && strcmp(argv[3], "--algorithm") == 0 ? argv[4] : "quick";
+        size_t count;
+        int *values = workload_load_ints(argv[2], &count);
+        if (values == NULL || count > 0x7FFFFFFF) {
+            fprintf(stderr, "Cannot read int workload %s\n", argv[2]);
+            free(values);
+            return 1;
+        }
+
+        int size = (int)count;
+        EVLOG_START_FROM_ENV();
+        PROBE_HW_START();
+        double start = omp_get_wtime();
+
+        bool completed = true;
+        if (strcmp(algorithm, "merge") == 0) parallelMergeSort(values, 0, size - 1);
+        else if (strcmp(algorithm, "bucket") == 0) completed = parallelBucketSort(values, size);
+        else if (strcmp(algorithm, "radix") == 0) completed = parallelRadixSort(values, size);
+        else parallelQuickSort(values, 0, size - 1);
+
+        double elapsed = omp_get_wtime() - start;
+        PROBE_HW_STOP();
+        PROBE_REPORT();
+        EVLOG_STOP();
+
+        if (!completed) {
+            fprintf(stderr, "Out of memory sorting %d values (%s)\n", size, algorithm);
+            free(values);
+            return 1;
+        }
+
+        bool sorted = true;
+        for (int i = 1; i < size && sorted; i++) sorted = values[i - 1] <= values[i];
+        printf("Sorted %d values (%s) in %.3f s: %s\n", size, algorithm, elapsed, sorted ? "ok" : "NOT SORTED");
+        free(values);
+        return sorted ? 0 : 1;
+    }
+
     int n = 50; // Array size
     int *arr = (int*)malloc(n * sizeof(int));
     
@@ -192,14 +426,24 @@ int main() {
     // Set number of threads for OpenMP
     omp_set_num_threads(4);
     
+    // Record step events to $EVLOG_PATH (builds with EVLOG_ENABLED)
+    EVLOG_START_FROM_ENV();
+    PROBE_HW_START();
+
     // Choose which sorting algorithm to use
     parallelQuickSort(arr, 0, n-1);
     // OR parallelMergeSort(arr, 0, n-1);
     // OR parallelBucketSort(arr, n);
+    // OR parallelRadixSort(arr, n);
+
+    PROBE_HW_STOP();
+    PROBE_REPORT();
+    EVLOG_STOP();
     
     printf("\nSorted array:\n");
     printArray(arr, n);
     
     free(arr);
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,43 @@
+#ifndef MSV_H
+#define MSV_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Key/index pair used by the record sorting API. Records are sorted by
+// permuting these pairs; the records themselves are moved once at the end.
+typedef struct {
+    long long key;
+    size_t index;
+} KeyIndex;
+
+// Out-of-core sort settings; zero/NULL fields fall back to defaults
+// (256 MB budget, $TMPDIR or /tmp for run files). The budget must be at
+// least 1 MB.
+typedef struct {
+    size_t memoryBudget;
+    const char *tempDir;
+} ExternalSortOptions;
+
+// Extracts the sort key from a single record
+typedef long long (*SortKeyFn)(const void *record);
+
+// Integer sorting engines
+void parallelQuickSort(int *arr, int low, int high);
+void parallelMergeSort(int *arr, int left, int right);
+bool parallelBucketSort(int *arr, int n);
+bool parallelRadixSort(int *arr, int n);
+void merge(int *arr, int left, int mid, int right);
+void quickSort(int *arr, int low, int high);
+void swap(int *a, int *b);
+void printArray(int *arr, int n);
+
+// Generic key/index and record sorting
+bool sortKeyIndex(KeyIndex *pairs, size_t n, bool stable);
+bool applyPermutation(void *base, size_t n, size_t size, KeyIndex *pairs);
+bool sortRecords(void *base, size_t n, size_t size, SortKeyFn key, bool stable);
+
+// External sorting of int files larger than memory (msv_external.c)
+bool externalSort(const char *inputPath, const char *outputPath, const ExternalSortOptions *options);
+
+#endif
@@ -0,0 +1,281 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <unistd.h>
+#include <omp.h>
+#include "msv.h"
+#include "workload.h"
+
+// Benchmark harness for the sorting engines.
+// Usage: msv_bench [--algos a,b] [--dists a,b] [--sizes n,m | --min-size N --max-size N]
+//                  [--threads 1,2,4] [--reps R] [--warmup W] [--seed S]
+//                  [--format csv|json] [--output FILE]
+
+#define MAX_LIST 64
+#define ZIPF_EXPONENT 1.1
+
+// Returns false if the engine ran out of scratch space
+typedef bool (*SortEngine)(int *arr, int n);
+
+typedef struct {
+    const char *name;
+    SortEngine sort;
+} Engine;
+
+typedef struct {
+    double mean;
+    double min;
+    double max;
+    double stddev;
+} Timing;
+
+static bool runQuickSort(int *arr, int n) { parallelQuickSort(arr, 0, n - 1); return true; }
+static bool runMergeSort(int *arr, int n) { parallelMergeSort(arr, 0, n - 1); return true; }
+static bool runBucketSort(int *arr, int n) { return parallelBucketSort(arr, n); }
+static bool runRadixSort(int *arr, int n) { return parallelRadixSort(arr, n); }
+
+static const Engine engines[] = {
+    {"quick", runQuickSort},
+    {"merge", runMergeSort},
+    {"bucket", runBucketSort},
+    {"radix", runRadixSort},
+};
+#define ENGINE_COUNT ((int)(sizeof(engines) / sizeof(engines[0])))
+
+// Inputs come from the shared workload generator: values are a pure function
+// of (seed, index), so they are identical for every thread count and run
+static void generateInput(int *arr, int n, Distribution dist, uint64_t seed) {
+    workload_fill_ints(arr, 0, n, n, dist, seed, ZIPF_EXPONENT);
+}
+
+// Order-independent fingerprint of the multiset of values
+static uint64_t fingerprint(const int *arr, int n) {
+    uint64_t sum = 0;
+
+    #pragma omp parallel for reduction(+:sum)
+    for (int i = 0; i < n; i++)
+        sum += workload_mix64((uint32_t)arr[i]);
+
+    return sum;
+}
+
+static bool isSorted(const int *arr, int n) {
+    int unsorted = 0;
+
+    #pragma omp parallel for reduction(|:unsorted)
+    for (int i = 1; i < n; i++)
+        unsorted |= arr[i - 1] > arr[i];
+
+    return !unsorted;
+}
+
+// Parse a comma-separated list into values (numbers, or names via lookup)
+static int parseList(const char *text, long long *values, const char *const *names, int nameCount) {
+    char buffer[1024];
+    int count = 0;
+    snprintf(buffer, sizeof(buffer), "%s", text);
+
+    for (char *token = strtok(buffer, ","); token && count < MAX_LIST; token = strtok(NULL, ",")) {
+        if (names == NULL) {
+            values[count++] = (long long)strtod(token, NULL);
+            continue;
+        }
+        int found = -1;
+        for (int i = 0; i < nameCount; i++) {
+            if (strcmp(token, names[i]) == 0) found = i;
+        }
+        if (found < 0) {
+            fprintf(stderr, "Unknown name: %s\n", token);
+            exit(2);
+        }
+        values[count++] = found;
+    }
+    return count;
+}
+
+static Timing summarize(const double *seconds, int reps) {
+    Timing timing = {0.0, seconds[0], seconds[0], 0.0};
+
+    for (int r = 0; r < reps; r++) {
+        timing.mean += seconds[r];
+        if (seconds[r] < timing.min) timing.min = seconds[r];
+        if (seconds[r] > timing.max) timing.max = seconds[r];
+    }
+    timing.mean /= reps;
+
+    for (int r = 0; r < reps; r++)
+        timing.stddev += (seconds[r] - timing.mean) * (seconds[r] - timing.mean);
+    timing.stddev = reps > 1 ? sqrt(timing.stddev / (reps - 1)) : 0.0;
+
+    return timing;
+}
+
+int main(int argc, char *argv[]) {
+    long long algos[MAX_LIST], dists[MAX_LIST], sizes[MAX_LIST], threads[MAX_LIST];
+    int algoCount = 0, distCount = 0, sizeCount = 0, threadCount = 0;
+    long long minSize = 1000, maxSize = 1000000000;
+    int reps = 5, warmup = 1;
+    uint64_t seed = 42;
+    bool json = false;
+    FILE *out = stdout;
+
+    const char *engineNames[ENGINE_COUNT];
+    for (int i = 0; i < ENGINE_COUNT; i++)
+        engineNames[i] = engines[i].name;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--algos") == 0)
+            algoCount = parseList(argv[i + 1], algos, engineNames, ENGINE_COUNT);
+        else if (strcmp(argv[i], "--dists") == 0)
+            distCount = parseList(argv[i + 1], dists, workload_distribution_names, DIST_COUNT);
+        else if (strcmp(argv[i], "--sizes") == 0)
+            sizeCount = parseList(argv[i + 1], sizes, NULL, 0);
+        else if (strcmp(argv[i], "--threads") == 0)
+            threadCount = parseList(argv[i + 1], threads, NULL, 0);
+        else if (strcmp(argv[i], "--min-size") == 0)
+            minSize = (long long)strtod(argv[i + 1], NULL);
+        else if (strcmp(argv[i], "--max-size") == 0)
+            maxSize = (long long)strtod(argv[i + 1], NULL);
+        else if (strcmp(argv[i], "--reps") == 0)
+            reps = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--warmup") == 0)
+            warmup = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seed") == 0)
+            seed = strtoull(argv[i + 1], NULL, 10);
+        else if (strcmp(argv[i], "--format") == 0)
+            json = strcmp(argv[i + 1], "json") == 0;
+        else if (strcmp(argv[i], "--output") == 0 && (out = fopen(argv[i + 1], "w")) == NULL) {
+            perror(argv[i + 1]);
+            return 2;
+        }
+    }
+    if (reps < 1) reps = 1;
+
+    // Defaults: every engine and distribution, decades from minSize to
+    // maxSize, and powers of two up to the processor count
+    if (algoCount == 0) {
+        for (int i = 0; i < ENGINE_COUNT; i++) algos[algoCount++] = i;
+    }
+    if (distCount == 0) {
+        for (int i = 0; i < DIST_COUNT; i++) dists[distCount++] = i;
+    }
+    if (sizeCount == 0) {
+        for (long long n = minSize; n <= maxSize && sizeCount < MAX_LIST; n *= 10) sizes[sizeCount++] = n;
+    }
+    if (threadCount == 0) {
+        int processors = omp_get_num_procs();
+        for (int t = 1; t < processors; t *= 2) threads[threadCount++] = t;
+        threads[threadCount++] = processors;
+    }
+
+    // Input, working copy and engine scratch space must fit in memory
+    double physicalMemory = (double)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+    double *seconds = (double*)malloc(reps * sizeof(double));
+    if (seconds == NULL) {
+        fprintf(stderr, "Cannot allocate timings for %d reps\n", reps);
+        return 1;
+    }
+    bool allVerified = true;
+    bool firstRow = true;
+
+    if (json)
+        fprintf(out, "{\"seed\": %llu, \"reps\": %d, \"results\": [\n", (unsigned long long)seed, reps);
+    else
+        fprintf(out, "algorithm,distribution,size,threads,reps,mean_s,min_s,max_s,stddev_s,"
+                     "cv,elements_per_s,speedup,efficiency,verified\n");
+
+    for (int s = 0; s < sizeCount; s++) {
+        long long size = sizes[s];
+        if (size < 1 || size > 0x7FFFFFFF || size * 3.0 * sizeof(int) > physicalMemory * 0.8) {
+            fprintf(stderr, "Skipping size %lld: exceeds int indexing or available memory\n", size);
+            continue;
+        }
+        int n = (int)size;
+        int *input = (int*)malloc(n * sizeof(int));
+        int *work = (int*)malloc(n * sizeof(int));
+        if (input == NULL || work == NULL) {
+            fprintf(stderr, "Skipping size %lld: cannot allocate input buffers\n", size);
+            free(input);
+            free(work);
+            continue;
+        }
+
+        for (int d = 0; d < distCount; d++) {
+            generateInput(input, n, (Distribution)dists[d], seed);
+            uint64_t expected = fingerprint(input, n);
+
+            for (int a = 0; a < algoCount; a++) {
+                const Engine *engine = &engines[algos[a]];
+                double baseMean = 0.0;
+                long long baseThreads = 0;
+
+                for (int t = 0; t < threadCount; t++) {
+                    omp_set_num_threads((int)threads[t]);
+                    bool verified = true;
+
+                    for (int r = -warmup; r < reps; r++) {
+                        memcpy(work, input, n * sizeof(int));
+                        double start = omp_get_wtime();
+                        bool completed = engine->sort(work, n);
+                        double elapsed = omp_get_wtime() - start;
+
+                        if (r >= 0) seconds[r] = elapsed;
+                        if (!completed) {
+                            fprintf(stderr, "%s: out of scratch memory at size %d\n", engine->name, n);
+                            verified = false;
+                        } else if (!isSorted(work, n) || fingerprint(work, n) != expected) {
+                            verified = false;
+                        }
+                    }
+
+                    // Speedup and efficiency are relative to the first thread count run
+                    Timing timing = summarize(seconds, reps);
+                    if (t == 0) {
+                        baseMean = timing.mean;
+                        baseThreads = threads[t];
+                    }
+                    double speedup = baseMean / timing.mean;
+                    double efficiency = speedup * baseThreads / threads[t];
+                    double rate = n / timing.mean;
+                    double cv = timing.stddev / timing.mean;
+                    allVerified = allVerified && verified;
+
+                    if (json) {
+                        fprintf(out, "%s  {\"algorithm\": \"%s\", \"distribution\": \"%s\", \"size\": %d, "
+                                     "\"threads\": %lld, \"reps\": %d, \"mean_s\": %.9f, \"min_s\": %.9f, "
+                                     "\"max_s\": %.9f, \"stddev_s\": %.9f, \"cv\": %.6f, "
+                                     "\"elements_per_s\": %.1f, \"speedup\": %.4f, \"efficiency\": %.4f, "
+                                     "\"verified\": %s}",
+                                firstRow ? "" : ",\n", engine->name, workload_distribution_names[dists[d]], n,
+                                threads[t], reps, timing.mean, timing.min, timing.max, timing.stddev,
+                                cv, rate, speedup, efficiency, verified ? "true" : "false");
+                    } else {
+                        fprintf(out, "%s,%s,%d,%lld,%d,%.9f,%.9f,%.9f,%.9f,%.6f,%.1f,%.4f,%.4f,%s\n",
+                                engine->name, workload_distribution_names[dists[d]], n, threads[t], reps,
+                                timing.mean, timing.min, timing.max, timing.stddev, cv, rate,
+                                speedup, efficiency, verified ? "true" : "false");
+                    }
+                    firstRow = false;
+                    fflush(out);
+                }
+            }
+        }
+
+        free(input);
+        free(work);
+    }
+
+    if (json)
+        fprintf(out, "\n]}\n");
+    if (out != stdout)
+        fclose(out);
+    free(seconds);
+
+    if (!allVerified) {
+        fprintf(stderr, "Verification failed for at least one run\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,499 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include "msv.h"
+
+#define DEFAULT_MEMORY_BUDGET (256UL << 20)
+#define MIN_MERGE_BUFFER (64UL << 10)
+// Smallest budget accepted: a two-way merge of MIN_MERGE_BUFFER-sized
+// buffers still fits beside a run held during run formation
+#define MIN_MEMORY_BUDGET (1UL << 20)
+#define RESERVED_FDS 16  // stdio, input, output, a merge target and the caller's own files
+
+// Per-run input with two buffers: one being merged, one being read ahead
+typedef struct {
+    int fd;
+    int *buffers[2];
+    size_t counts[2];
+    bool ready[2];
+    int active;
+    size_t position;
+} MergeInput;
+
+// Background reader servicing buffer refill requests in FIFO order
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    MergeInput *inputs;
+    size_t bufferElements;
+    int *queue;
+    int queueCapacity;
+    int queueHead;
+    int queueTail;
+    bool stop;
+    bool failed;
+} ReadAhead;
+
+// Background writer draining one full output buffer while the other fills
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    int fd;
+    int *pending;
+    size_t pendingCount;
+    bool stop;
+    bool failed;
+} WriteBehind;
+
+// Read exactly count bytes unless end of file is reached first
+static ssize_t readFully(int fd, void *buffer, size_t count) {
+    size_t done = 0;
+    while (done < count) {
+        ssize_t got = read(fd, (char*)buffer + done, count - done);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (got == 0) break;
+        done += got;
+    }
+    return done;
+}
+
+static bool writeFully(int fd, const void *buffer, size_t count) {
+    size_t done = 0;
+    while (done < count) {
+        ssize_t put = write(fd, (const char*)buffer + done, count - done);
+        if (put < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        done += put;
+    }
+    return true;
+}
+
+// Create an anonymous temporary file; it disappears once closed
+static int openTempFile(const char *tempDir) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/msv-run-XXXXXX", tempDir);
+    int fd = mkstemp(path);
+    if (fd >= 0) unlink(path);
+    return fd;
+}
+
+static void *readAheadThread(void *arg) {
+    ReadAhead *reader = (ReadAhead*)arg;
+
+    pthread_mutex_lock(&reader->lock);
+    while (1) {
+        while (!reader->stop && reader->queueHead == reader->queueTail)
+            pthread_cond_wait(&reader->changed, &reader->lock);
+        if (reader->stop) break;
+
+        int request = reader->queue[reader->queueHead];
+        reader->queueHead = (reader->queueHead + 1) % reader->queueCapacity;
+        MergeInput *input = &reader->inputs[request >> 1];
+        int buffer = request & 1;
+        pthread_mutex_unlock(&reader->lock);
+
+        ssize_t got = readFully(input->fd, input->buffers[buffer],
+                                reader->bufferElements * sizeof(int));
+
+        pthread_mutex_lock(&reader->lock);
+        if (got < 0) {
+            reader->failed = true;
+            got = 0;
+        }
+        input->counts[buffer] = got / sizeof(int);
+        input->ready[buffer] = true;
+        pthread_cond_broadcast(&reader->changed);
+    }
+    pthread_mutex_unlock(&reader->lock);
+    return NULL;
+}
+
+static void requestRefill(ReadAhead *reader, int run, int buffer) {
+    pthread_mutex_lock(&reader->lock);
+    reader->inputs[run].ready[buffer] = false;
+    reader->queue[reader->queueTail] = (run << 1) | buffer;
+    reader->queueTail = (reader->queueTail + 1) % reader->queueCapacity;
+    pthread_cond_broadcast(&reader->changed);
+    pthread_mutex_unlock(&reader->lock);
+}
+
+static void waitReady(ReadAhead *reader, int run, int buffer) {
+    pthread_mutex_lock(&reader->lock);
+    while (!reader->inputs[run].ready[buffer])
+        pthread_cond_wait(&reader->changed, &reader->lock);
+    pthread_mutex_unlock(&reader->lock);
+}
+
+static void *writeBehindThread(void *arg) {
+    WriteBehind *writer = (WriteBehind*)arg;
+
+    pthread_mutex_lock(&writer->lock);
+    while (1) {
+        while (!writer->stop && writer->pending == NULL)
+            pthread_cond_wait(&writer->changed, &writer->lock);
+        if (writer->pending == NULL) break;
+
+        int *buffer = writer->pending;
+        size_t count = writer->pendingCount;
+        pthread_mutex_unlock(&writer->lock);
+
+        bool written = writeFully(writer->fd, buffer, count * sizeof(int));
+
+        pthread_mutex_lock(&writer->lock);
+        if (!written) writer->failed = true;
+        writer->pending = NULL;
+        pthread_cond_broadcast(&writer->changed);
+    }
+    pthread_mutex_unlock(&writer->lock);
+    return NULL;
+}
+
+// Hand a full buffer to the writer once it has finished the previous one
+static void submitWrite(WriteBehind *writer, int *buffer, size_t count) {
+    pthread_mutex_lock(&writer->lock);
+    while (writer->pending != NULL)
+        pthread_cond_wait(&writer->changed, &writer->lock);
+    writer->pending = buffer;
+    writer->pendingCount = count;
+    pthread_cond_broadcast(&writer->changed);
+    pthread_mutex_unlock(&writer->lock);
+}
+
+static void drainWrites(WriteBehind *writer) {
+    pthread_mutex_lock(&writer->lock);
+    while (writer->pending != NULL)
+        pthread_cond_wait(&writer->changed, &writer->lock);
+    pthread_mutex_unlock(&writer->lock);
+}
+
+// Current head of a run, or LLONG_MAX once the run is exhausted
+static long long headKey(MergeInput *input) {
+    if (input->position < input->counts[input->active])
+        return input->buffers[input->active][input->position];
+    return LLONG_MAX;
+}
+
+// Loser tree: nodes[1..k-1] hold the loser of each match, nodes[0] the winner
+static int buildLoserTree(int *nodes, MergeInput *inputs, int k, int node) {
+    if (node >= k) return node - k;
+
+    int left = buildLoserTree(nodes, inputs, k, 2 * node);
+    int right = buildLoserTree(nodes, inputs, k, 2 * node + 1);
+    if (headKey(&inputs[left]) <= headKey(&inputs[right])) {
+        nodes[node] = right;
+        return left;
+    }
+    nodes[node] = left;
+    return right;
+}
+
+// Advance run to its next element, switching to the read-ahead buffer when needed
+static void advanceInput(ReadAhead *reader, int run) {
+    MergeInput *input = &reader->inputs[run];
+    input->position++;
+    if (input->position < input->counts[input->active]) return;
+
+    // An empty buffer marks the end of the run; don't refill past it
+    if (input->counts[input->active] == 0) return;
+
+    int finished = input->active;
+    input->active ^= 1;
+    input->position = 0;
+    waitReady(reader, run, input->active);
+    if (input->counts[input->active] == reader->bufferElements)
+        requestRefill(reader, run, finished);
+    else
+        input->counts[finished] = 0;
+}
+
+// Loser-tree merge of primed inputs into the output buffers
+static void mergeLoop(ReadAhead *reader, WriteBehind *writer, int *nodes, int k, int *outputBuffers[2]) {
+    MergeInput *inputs = reader->inputs;
+    size_t bufferElements = reader->bufferElements;
+
+    // Prime both buffers of every run so the first switch never stalls
+    for (int i = 0; i < k; i++) {
+        requestRefill(reader, i, 0);
+        requestRefill(reader, i, 1);
+    }
+    for (int i = 0; i < k; i++)
+        waitReady(reader, i, 0);
+
+    nodes[0] = buildLoserTree(nodes, inputs, k, 1);
+
+    int outputIndex = 0;
+    size_t outputCount = 0;
+    while (1) {
+        int winner = nodes[0];
+        long long key = headKey(&inputs[winner]);
+        if (key == LLONG_MAX) break;
+
+        outputBuffers[outputIndex][outputCount++] = (int)key;
+        if (outputCount == bufferElements) {
+            submitWrite(writer, outputBuffers[outputIndex], outputCount);
+            outputIndex ^= 1;
+            outputCount = 0;
+        }
+
+        advanceInput(reader, winner);
+
+        // Replay the matches on the path from the winner's leaf to the root
+        long long winnerKey = headKey(&inputs[winner]);
+        for (int node = (winner + k) / 2; node > 0; node /= 2) {
+            long long loserKey = headKey(&inputs[nodes[node]]);
+            if (loserKey < winnerKey) {
+                int temp = nodes[node];
+                nodes[node] = winner;
+                winner = temp;
+                winnerKey = loserKey;
+            }
+        }
+        nodes[0] = winner;
+    }
+
+    if (outputCount > 0)
+        submitWrite(writer, outputBuffers[outputIndex], outputCount);
+    drainWrites(writer);
+
+    // Wait for outstanding refills before tearing the reader down
+    for (int i = 0; i < k; i++) {
+        waitReady(reader, i, 0);
+        waitReady(reader, i, 1);
+    }
+}
+
+// Merge the given sorted runs (rewound to their start) into outputFd.
+// Returns false if a buffer or thread can't be created or I/O fails.
+static bool mergeRuns(int *runFds, int k, int outputFd, size_t budget) {
+    size_t bufferElements = budget / ((2 * k + 2) * sizeof(int));
+
+    MergeInput *inputs = (MergeInput*)calloc(k, sizeof(MergeInput));
+    int *nodes = (int*)malloc((k + 1) * sizeof(int));
+    int *outputBuffers[2];
+    outputBuffers[0] = (int*)malloc(bufferElements * sizeof(int));
+    outputBuffers[1] = (int*)malloc(bufferElements * sizeof(int));
+
+    ReadAhead reader = {0};
+    pthread_mutex_init(&reader.lock, NULL);
+    pthread_cond_init(&reader.changed, NULL);
+    reader.inputs = inputs;
+    reader.bufferElements = bufferElements;
+    reader.queueCapacity = 2 * k + 1;
+    reader.queue = (int*)malloc(reader.queueCapacity * sizeof(int));
+
+    WriteBehind writer = {0};
+    pthread_mutex_init(&writer.lock, NULL);
+    pthread_cond_init(&writer.changed, NULL);
+    writer.fd = outputFd;
+
+    bool ok = bufferElements > 0 && inputs != NULL && nodes != NULL && outputBuffers[0] != NULL &&
+              outputBuffers[1] != NULL && reader.queue != NULL;
+    for (int i = 0; ok && i < k; i++) {
+        inputs[i].fd = runFds[i];
+        inputs[i].buffers[0] = (int*)malloc(bufferElements * sizeof(int));
+        inputs[i].buffers[1] = (int*)malloc(bufferElements * sizeof(int));
+        ok = inputs[i].buffers[0] != NULL && inputs[i].buffers[1] != NULL &&
+             lseek(runFds[i], 0, SEEK_SET) == 0;
+    }
+
+    // pthread_create reports failure through its result, not errno
+    pthread_t readerThread, writerThread;
+    int error = ok ? pthread_create(&readerThread, NULL, readAheadThread, &reader) : -1;
+    bool readerStarted = error == 0;
+    if (readerStarted) error = pthread_create(&writerThread, NULL, writeBehindThread, &writer);
+    bool writerStarted = readerStarted && error == 0;
+    if (error > 0) errno = error;
+    ok = writerStarted;
+
+    if (ok)
+        mergeLoop(&reader, &writer, nodes, k, outputBuffers);
+
+    if (readerStarted) {
+        pthread_mutex_lock(&reader.lock);
+        reader.stop = true;
+        pthread_cond_broadcast(&reader.changed);
+        pthread_mutex_unlock(&reader.lock);
+        pthread_join(readerThread, NULL);
+    }
+    if (writerStarted) {
+        pthread_mutex_lock(&writer.lock);
+        writer.stop = true;
+        pthread_cond_broadcast(&writer.changed);
+        pthread_mutex_unlock(&writer.lock);
+        pthread_join(writerThread, NULL);
+    }
+
+    ok = ok && !reader.failed && !writer.failed;
+
+    for (int i = 0; inputs != NULL && i < k; i++) {
+        free(inputs[i].buffers[0]);
+        free(inputs[i].buffers[1]);
+    }
+    free(inputs);
+    free(nodes);
+    free(outputBuffers[0]);
+    free(outputBuffers[1]);
+    free(reader.queue);
+    pthread_mutex_destroy(&reader.lock);
+    pthread_cond_destroy(&reader.changed);
+    pthread_mutex_destroy(&writer.lock);
+    pthread_cond_destroy(&writer.changed);
+    return ok;
+}
+
+// Largest fan-in that keeps every merge buffer at least MIN_MERGE_BUFFER
+// within budget and every open run within the descriptor limit
+static int fanInLimit(size_t budget) {
+    long long fanIn = (long long)(budget / (2 * MIN_MERGE_BUFFER)) - 1;
+
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY &&
+        (long long)limit.rlim_cur - RESERVED_FDS < fanIn)
+        fanIn = (long long)limit.rlim_cur - RESERVED_FDS;
+
+    if (fanIn > INT_MAX) fanIn = INT_MAX;
+    return fanIn < 2 ? 2 : (int)fanIn;
+}
+
+// Make room for one more run file descriptor
+static bool reserveRun(int **runFds, int runCount, int *runCapacity) {
+    if (runCount < *runCapacity) return true;
+
+    int capacity = *runCapacity ? *runCapacity * 2 : 16;
+    int *grown = (int*)realloc(*runFds, capacity * sizeof(int));
+    if (grown == NULL) return false;
+    *runFds = grown;
+    *runCapacity = capacity;
+    return true;
+}
+
+// Merge the oldest fanIn open runs into a new run appended to the list.
+// On failure the list is unchanged and its runs stay open.
+static bool mergeOldestRuns(int **runFds, int *first, int *runCount, int *runCapacity,
+                            int fanIn, size_t budget, const char *tempDir) {
+    if (!reserveRun(runFds, *runCount, runCapacity)) return false;
+
+    int fd = openTempFile(tempDir);
+    if (fd < 0 || !mergeRuns(*runFds + *first, fanIn, fd, budget)) {
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    for (int i = *first; i < *first + fanIn; i++)
+        close((*runFds)[i]);
+    *first += fanIn;
+    (*runFds)[(*runCount)++] = fd;
+    return true;
+}
+
+// Sort a binary file of native-endian ints that may be larger than memory.
+// Runs of budget/2 bytes are sorted in parallel and spilled to temporary
+// files, then merged with a loser tree in as many passes as the budget's
+// fan-in allows. Whenever the open runs reach the descriptor limit during
+// run formation, the oldest are merged early using the half of the budget
+// not held by the run buffer. Budgets below MIN_MEMORY_BUDGET fail with EINVAL.
+bool externalSort(const char *inputPath, const char *outputPath, const ExternalSortOptions *options) {
+    size_t budget = options && options->memoryBudget ? options->memoryBudget : DEFAULT_MEMORY_BUDGET;
+    if (budget < MIN_MEMORY_BUDGET) {
+        errno = EINVAL;
+        return false;
+    }
+    const char *tempDir = options && options->tempDir ? options->tempDir : getenv("TMPDIR");
+    if (tempDir == NULL) tempDir = "/tmp";
+
+    int inputFd = open(inputPath, O_RDONLY);
+    if (inputFd < 0) return false;
+
+    struct stat info;
+    if (fstat(inputFd, &info) < 0 || info.st_size % sizeof(int) != 0) {
+        close(inputFd);
+        errno = EINVAL;
+        return false;
+    }
+    posix_fadvise(inputFd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    int outputFd = open(outputPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (outputFd < 0) {
+        close(inputFd);
+        return false;
+    }
+
+    // The radix engine needs scratch space equal to the run it sorts
+    size_t runElements = budget / (2 * sizeof(int));
+    if (runElements > INT_MAX) runElements = INT_MAX;
+    if (runElements == 0) runElements = 1;
+    int *run = (int*)malloc(runElements * sizeof(int));
+
+    int maxFanIn = fanInLimit(budget);
+    int formationFanIn = fanInLimit(budget / 2);
+    int *runFds = NULL;
+    int first = 0;
+    int runCount = 0;
+    int runCapacity = 0;
+    bool ok = run != NULL;
+
+    while (ok) {
+        ssize_t got = readFully(inputFd, run, runElements * sizeof(int));
+        if (got < 0) ok = false;
+        if (got <= 0) break;
+
+        size_t count = got / sizeof(int);
+        if (!parallelRadixSort(run, (int)count)) {
+            ok = false;
+            break;
+        }
+
+        // A single run is the whole input: write it straight to the output
+        if (runCount == 0 && count < runElements) {
+            ok = writeFully(outputFd, run, count * sizeof(int));
+            break;
+        }
+
+        if (!reserveRun(&runFds, runCount, &runCapacity)) {
+            ok = false;
+            break;
+        }
+        int fd = openTempFile(tempDir);
+        if (fd < 0 || !writeFully(fd, run, count * sizeof(int))) {
+            if (fd >= 0) close(fd);
+            ok = false;
+            break;
+        }
+        runFds[runCount++] = fd;
+
+        if (runCount - first >= maxFanIn &&
+            !mergeOldestRuns(&runFds, &first, &runCount, &runCapacity, formationFanIn, budget / 2, tempDir)) {
+            ok = false;
+            break;
+        }
+
+        if (count < runElements) break;
+    }
+    free(run);
+    close(inputFd);
+
+    while (ok && runCount - first > maxFanIn)
+        ok = mergeOldestRuns(&runFds, &first, &runCount, &runCapacity, maxFanIn, budget, tempDir);
+
+    if (ok && runCount - first > 0)
+        ok = mergeRuns(runFds + first, runCount - first, outputFd, budget);
+
+    for (int i = first; i < runCount; i++)
+        close(runFds[i]);
+    free(runFds);
+
+    if (close(outputFd) < 0) ok = false;
+    return ok;
+}
@@ -0,0 +1,207 @@
+// Sort kernels shared by the integer engines and the key/index pairs behind
+// sortRecords(). msv.c includes this file once per element type, after
+// defining:
+//   SORT_TYPE                           element type
+//   SORT_SUFFIX                         appended to each generated function name
+//   SORT_KEY(element)                   integer key, compared as long long
+//   SORT_TRACE_COMPARE(a, b)            event hooks, given absolute indices;
+//   SORT_TRACE_SWAP(a, b)               define as ((void)0) for untraced types
+//   SORT_TRACE_MOVE(index, element)
+//   SORT_TRACE_SPLIT(low, split, high)
+// Ranges are passed as (data, n, origin), where origin is the absolute index
+// of data[0] and is only used to name positions in events. The parameters
+// are undefined again at the end so the next inclusion starts clean.
+
+#define SORT_CONCAT_(name, suffix) name##suffix
+#define SORT_CONCAT(name, suffix) SORT_CONCAT_(name, suffix)
+#define SORT_FN(name) SORT_CONCAT(name, SORT_SUFFIX)
+
+static inline void SORT_FN(swapElements)(SORT_TYPE *a, SORT_TYPE *b) {
+    SORT_TYPE temp = *a;
+    *a = *b;
+    *b = temp;
+}
+
+// Stable insertion sort for short ranges at the bottom of the recursive
+// sorts. The element being placed is held out of the array, so comparisons
+// name the hole and every shift and the final placement log a move.
+static void SORT_FN(insertionSort)(SORT_TYPE *data, size_t n, size_t origin) {
+    for (size_t i = 1; i < n; i++) {
+        SORT_TYPE current = data[i];
+        size_t j = i;
+        while (j > 0) {
+            SORT_TRACE_COMPARE(origin + j - 1, origin + j);
+            if (SORT_KEY(data[j - 1]) <= SORT_KEY(current)) break;
+            SORT_TRACE_MOVE(origin + j, data[j - 1]);
+            data[j] = data[j - 1];
+            j--;
+        }
+        // One comparison per shift, plus the one that stopped the scan
+        PROBE_COUNT(PROBE_MSV_COMPARISONS, (i - j) + (j > 0));
+        if (j != i) {
+            SORT_TRACE_MOVE(origin + j, current);
+            data[j] = current;
+        }
+    }
+}
+
+// Hoare partition around a median-of-three pivot. On return every element of
+// data[0..split] is <= every element of data[split+1..n-1]; elements equal to
+// the pivot stop both scans, so sorted and few-unique inputs split evenly.
+static size_t SORT_FN(partition)(SORT_TYPE *data, size_t n, size_t origin) {
+    PROBE_SCOPE(PROBE_TIMER_PARTITION);
+    PROBE_COUNT(PROBE_MSV_PARTITIONS, 1);
+
+    size_t high = n - 1;
+    size_t mid = high / 2;
+    SORT_TRACE_COMPARE(origin + mid, origin);
+    if (SORT_KEY(data[mid]) < SORT_KEY(data[0])) {
+        SORT_TRACE_SWAP(origin + mid, origin);
+        SORT_FN(swapElements)(&data[mid], &data[0]);
+    }
+    SORT_TRACE_COMPARE(origin + high, origin);
+    if (SORT_KEY(data[high]) < SORT_KEY(data[0])) {
+        SORT_TRACE_SWAP(origin + high, origin);
+        SORT_FN(swapElements)(&data[high], &data[0]);
+    }
+    SORT_TRACE_COMPARE(origin + high, origin + mid);
+    if (SORT_KEY(data[high]) < SORT_KEY(data[mid])) {
+        SORT_TRACE_SWAP(origin + high, origin + mid);
+        SORT_FN(swapElements)(&data[high], &data[mid]);
+    }
+    long long pivot = SORT_KEY(data[mid]);
+
+    // The scans compare against the pivot's current position, which moves
+    // when a swap takes it, so logged compares always name the pivot value
+    size_t pivotIndex = mid;
+    size_t i = 0;
+    size_t j = high;
+    while (1) {
+        while (1) {
+            SORT_TRACE_COMPARE(origin + i, origin + pivotIndex);
+            if (!(SORT_KEY(data[i]) < pivot)) break;
+            i++;
+        }
+        while (1) {
+            SORT_TRACE_COMPARE(origin + j, origin + pivotIndex);
+            if (!(SORT_KEY(data[j]) > pivot)) break;
+            j--;
+        }
+        if (i >= j) {
+            // Each scan compares once per step plus once where it stops,
+            // which sums to this; the median-of-three adds three more
+            PROBE_COUNT(PROBE_MSV_COMPARISONS, i + (high - j) + 5);
+            SORT_TRACE_SPLIT(origin, origin + j, origin + high);
+            return j;
+        }
+        SORT_TRACE_SWAP(origin + i, origin + j);
+        PROBE_COUNT(PROBE_MSV_SWAPS, 1);
+        if (pivotIndex == i) pivotIndex = j;
+        else if (pivotIndex == j) pivotIndex = i;
+        SORT_FN(swapElements)(&data[i++], &data[j--]);
+    }
+}
+
+// Recurse on the smaller side (as a task when spawning) and loop on the
+// larger one, keeping the stack depth logarithmic
+static void SORT_FN(quickSort)(SORT_TYPE *data, size_t n, size_t origin, bool spawn) {
+    while (n > INSERTION_CUTOFF + 1) {
+        size_t leftSize = SORT_FN(partition)(data, n, origin) + 1;
+        size_t rightSize = n - leftSize;
+
+        if (leftSize <= rightSize) {
+            #pragma omp task if(spawn && leftSize > TASK_CUTOFF)
+            SORT_FN(quickSort)(data, leftSize, origin, spawn);
+            data += leftSize;
+            origin += leftSize;
+            n = rightSize;
+        } else {
+            #pragma omp task if(spawn && rightSize > TASK_CUTOFF)
+            SORT_FN(quickSort)(data + leftSize, rightSize, origin + leftSize, spawn);
+            n = leftSize;
+        }
+    }
+    SORT_FN(insertionSort)(data, n, origin);
+}
+
+// Parallel LSD radix sort (8-bit digits, stable) on SORT_KEY(element) - bias,
+// read as unsigned, over the digits that range spans. Passes where every
+// element shares a digit are skipped. Returns false, leaving data unchanged,
+// if the scratch buffers can't be allocated.
+static bool SORT_FN(radixSort)(SORT_TYPE *data, size_t n, unsigned long long bias, unsigned long long range) {
+    SORT_TYPE *buffer = (SORT_TYPE*)malloc(n * sizeof(SORT_TYPE));
+    size_t *counts = (size_t*)malloc(omp_get_max_threads() * RADIX_BUCKETS * sizeof(size_t));
+    if (buffer == NULL || counts == NULL) {
+        free(buffer);
+        free(counts);
+        return false;
+    }
+
+    SORT_TYPE *src = data;
+    SORT_TYPE *dst = buffer;
+    for (int shift = 0; shift < 64 && (range >> shift) != 0; shift += 8) {
+        bool skipPass = false;
+
+        #pragma omp parallel if(n > PARALLEL_CUTOFF)
+        {
+            int thread = omp_get_thread_num();
+            int threadCount = omp_get_num_threads();
+            size_t *histogram = &counts[thread * RADIX_BUCKETS];
+            size_t begin = n * thread / threadCount;
+            size_t end = n * (thread + 1) / threadCount;
+
+            memset(histogram, 0, RADIX_BUCKETS * sizeof(size_t));
+            for (size_t i = begin; i < end; i++)
+                histogram[(((unsigned long long)SORT_KEY(src[i]) - bias) >> shift) & 0xFF]++;
+
+            #pragma omp barrier
+            #pragma omp single
+            {
+                // Prefix sums in (digit, thread) order keep the pass stable
+                size_t offset = 0;
+                for (int d = 0; d < RADIX_BUCKETS; d++) {
+                    for (int t = 0; t < threadCount; t++) {
+                        size_t count = counts[t * RADIX_BUCKETS + d];
+                        if (count == n) skipPass = true;
+                        counts[t * RADIX_BUCKETS + d] = offset;
+                        offset += count;
+                    }
+                }
+            }
+
+            // Each pass rewrites every position, so logging its moves is
+            // enough to replay the pass whichever buffer it lands in
+            if (!skipPass) {
+                for (size_t i = begin; i < end; i++) {
+                    size_t position = histogram[(((unsigned long long)SORT_KEY(src[i]) - bias) >> shift) & 0xFF]++;
+                    SORT_TRACE_MOVE(position, src[i]);
+                    dst[position] = src[i];
+                }
+            }
+        }
+
+        if (!skipPass) {
+            SORT_TYPE *temp = src;
+            src = dst;
+            dst = temp;
+        }
+    }
+
+    if (src != data)
+        memcpy(data, src, n * sizeof(SORT_TYPE));
+
+    free(buffer);
+    free(counts);
+    return true;
+}
+
+#undef SORT_FN
+#undef SORT_CONCAT
+#undef SORT_CONCAT_
+#undef SORT_TYPE
+#undef SORT_SUFFIX
+#undef SORT_KEY
+#undef SORT_TRACE_COMPARE
+#undef SORT_TRACE_SWAP
+#undef SORT_TRACE_MOVE
+#undef SORT_TRACE_SPLIT
@@ -0,0 +1,31 @@
+#include "msv.h"
+#include "wasm.h"
+
+// WebAssembly exports for the sorting engine. The caller allocates the array
+// with _malloc, fills it through an Int32Array view and sorts it in place.
+
+enum {
+    WASM_SORT_QUICK,
+    WASM_SORT_MERGE,
+    WASM_SORT_BUCKET,
+    WASM_SORT_RADIX
+};
+
+WASM_EXPORT void msvSort(int algorithm, int *arr, int n) {
+    if (n < 2) return;
+
+    switch (algorithm) {
+        case WASM_SORT_QUICK:
+            parallelQuickSort(arr, 0, n - 1);
+            break;
+        case WASM_SORT_MERGE:
+            parallelMergeSort(arr, 0, n - 1);
+            break;
+        case WASM_SORT_BUCKET:
+            parallelBucketSort(arr, n);
+            break;
+        case WASM_SORT_RADIX:
+            parallelRadixSort(arr, n);
+            break;
+    }
+}
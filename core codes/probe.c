@@ -0,0 +1,191 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "probe.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#define PROBE_MAX_THREADS 256
+#define PROBE_CACHE_LINE 64
+
+_Thread_local ProbeThreadData *probe_local = NULL;
+
+static ProbeThreadData *thread_data[PROBE_MAX_THREADS];
+static _Alignas(PROBE_CACHE_LINE) ProbeThreadData overflow_data;
+static int thread_count = 0;
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static bool hardware_available = false;
+static uint64_t hardware_totals[PROBE_HW_COUNT];
+static int hardware_fds[PROBE_HW_COUNT] = {-1, -1, -1};
+
+static const char *counter_names[PROBE_COUNTER_COUNT] = {
+    "msv.partitions",
+    "msv.comparisons",
+    "msv.swaps",
+    "psv.dispatches",
+    "psv.idle_ticks",
+    "mas.find_calls",
+    "mas.blocks_scanned",
+    "dead.safety_checks",
+    "dead.need_comparisons",
+    "sim.events",
+    "sim.wakeups"
+};
+
+static const char *timer_names[PROBE_TIMER_COUNT] = {
+    "msv.partition",
+    "psv.schedule",
+    "mas.find_suitable_block",
+    "dead.safety_check",
+    "sim.run"
+};
+
+static const char *hardware_names[PROBE_HW_COUNT] = {
+    "cycles", "branch-misses", "cache-misses"
+};
+
+// Give the calling thread its own counter block on first use, on cache lines
+// of its own so neighbouring threads' increments don't contend. Threads past
+// PROBE_MAX_THREADS, or whose block can't be allocated, share one block,
+// which may lose counts under contention.
+ProbeThreadData *probe_register_thread(void) {
+    size_t size = (sizeof(ProbeThreadData) + PROBE_CACHE_LINE - 1) & ~(size_t)(PROBE_CACHE_LINE - 1);
+
+    pthread_mutex_lock(&registry_lock);
+    ProbeThreadData *data = &overflow_data;
+    ProbeThreadData *block = thread_count < PROBE_MAX_THREADS
+                             ? (ProbeThreadData*)aligned_alloc(PROBE_CACHE_LINE, size) : NULL;
+    if (block != NULL) {
+        memset(block, 0, size);
+        thread_data[thread_count++] = block;
+        data = block;
+    }
+    pthread_mutex_unlock(&registry_lock);
+
+    probe_local = data;
+    return data;
+}
+
+// Zero every thread's counters; call while no probed code is running
+void probe_reset(void) {
+    pthread_mutex_lock(&registry_lock);
+    for (int i = 0; i < thread_count; i++)
+        memset(thread_data[i], 0, sizeof(ProbeThreadData));
+    memset(&overflow_data, 0, sizeof(overflow_data));
+    memset(hardware_totals, 0, sizeof(hardware_totals));
+    pthread_mutex_unlock(&registry_lock);
+}
+
+void probe_snapshot(ProbeReport *report) {
+    memset(report, 0, sizeof(*report));
+
+    pthread_mutex_lock(&registry_lock);
+    for (int t = 0; t <= thread_count; t++) {
+        ProbeThreadData *data = t < thread_count ? thread_data[t] : &overflow_data;
+        for (int c = 0; c < PROBE_COUNTER_COUNT; c++)
+            report->totals.counters[c] += data->counters[c];
+        for (int i = 0; i < PROBE_TIMER_COUNT; i++) {
+            report->totals.timerCycles[i] += data->timerCycles[i];
+            report->totals.timerCalls[i] += data->timerCalls[i];
+        }
+    }
+    report->threads = thread_count;
+    report->hardwareAvailable = hardware_available;
+    memcpy(report->hardware, hardware_totals, sizeof(hardware_totals));
+    pthread_mutex_unlock(&registry_lock);
+}
+
+void probe_report(FILE *out) {
+    ProbeReport report;
+    probe_snapshot(&report);
+
+    fprintf(out, "Probe report (%d thread%s)\n", report.threads, report.threads == 1 ? "" : "s");
+    for (int c = 0; c < PROBE_COUNTER_COUNT; c++) {
+        if (report.totals.counters[c] > 0)
+            fprintf(out, "  %-24s %llu\n", counter_names[c], (unsigned long long)report.totals.counters[c]);
+    }
+    for (int i = 0; i < PROBE_TIMER_COUNT; i++) {
+        uint64_t calls = report.totals.timerCalls[i];
+        if (calls > 0)
+            fprintf(out, "  %-24s %llu calls, %llu ticks, %.1f ticks/call\n", timer_names[i],
+                    (unsigned long long)calls, (unsigned long long)report.totals.timerCycles[i],
+                    (double)report.totals.timerCycles[i] / calls);
+    }
+    if (report.hardwareAvailable) {
+        for (int h = 0; h < PROBE_HW_COUNT; h++)
+            fprintf(out, "  %-24s %llu\n", hardware_names[h], (unsigned long long)report.hardware[h]);
+    }
+}
+
+// Open and enable the hardware counters; false when unsupported or denied
+// (for example by kernel.perf_event_paranoid)
+bool probe_hw_start(void) {
+#ifdef __linux__
+    static const uint64_t configs[PROBE_HW_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_MISSES
+    };
+
+    for (int h = 0; h < PROBE_HW_COUNT; h++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[h];
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        hardware_fds[h] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (hardware_fds[h] < 0) {
+            for (int i = 0; i < h; i++) {
+                close(hardware_fds[i]);
+                hardware_fds[i] = -1;
+            }
+            return false;
+        }
+    }
+
+    for (int h = 0; h < PROBE_HW_COUNT; h++) {
+        ioctl(hardware_fds[h], PERF_EVENT_IOC_RESET, 0);
+        ioctl(hardware_fds[h], PERF_EVENT_IOC_ENABLE, 0);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Stop the hardware counters and add their values to the report
+void probe_hw_stop(void) {
+#ifdef __linux__
+    if (hardware_fds[0] < 0) return;
+
+    for (int h = 0; h < PROBE_HW_COUNT; h++) {
+        uint64_t value = 0;
+        ioctl(hardware_fds[h], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(hardware_fds[h], &value, sizeof(value)) == sizeof(value))
+            hardware_totals[h] += value;
+        close(hardware_fds[h]);
+        hardware_fds[h] = -1;
+    }
+    hardware_available = true;
+#endif
+}
+
+const char *probe_counter_name(ProbeCounter counter) {
+    return counter < PROBE_COUNTER_COUNT ? counter_names[counter] : "unknown";
+}
+
+const char *probe_timer_name(ProbeTimer timer) {
+    return timer < PROBE_TIMER_COUNT ? timer_names[timer] : "unknown";
+}
@@ -0,0 +1,126 @@
+#ifndef PROBE_H
+#define PROBE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+// Hot-path counters and scoped cycle timers for the engines.
+//
+// Each thread accumulates into its own counter block, so probes are plain
+// increments with no atomics or sharing. probe_snapshot() sums the blocks
+// for reporting. Build with -DPROBES_ENABLED (and link probe.c with
+// -pthread) to compile the probes in; otherwise every PROBE_* macro expands
+// to nothing.
+//
+// On Linux, probe_hw_start()/probe_hw_stop() also read hardware counters
+// (cycles, branch misses, cache misses) through perf_event_open. These count
+// the calling thread and any threads it creates while they are running.
+
+typedef enum {
+    PROBE_MSV_PARTITIONS,
+    PROBE_MSV_COMPARISONS,
+    PROBE_MSV_SWAPS,
+    PROBE_PSV_DISPATCHES,
+    PROBE_PSV_IDLE_TICKS,
+    PROBE_MAS_FIND_CALLS,
+    PROBE_MAS_BLOCKS_SCANNED,
+    PROBE_DEAD_SAFETY_CHECKS,
+    PROBE_DEAD_NEED_COMPARISONS,
+    PROBE_SIM_EVENTS,
+    PROBE_SIM_WAKEUPS,
+    PROBE_COUNTER_COUNT
+} ProbeCounter;
+
+typedef enum {
+    PROBE_TIMER_PARTITION,
+    PROBE_TIMER_SCHEDULE,
+    PROBE_TIMER_FIND_BLOCK,
+    PROBE_TIMER_SAFETY_CHECK,
+    PROBE_TIMER_SIM_RUN,
+    PROBE_TIMER_COUNT
+} ProbeTimer;
+
+typedef enum {
+    PROBE_HW_CYCLES,
+    PROBE_HW_BRANCH_MISSES,
+    PROBE_HW_CACHE_MISSES,
+    PROBE_HW_COUNT
+} ProbeHardwareCounter;
+
+typedef struct {
+    uint64_t counters[PROBE_COUNTER_COUNT];
+    uint64_t timerCycles[PROBE_TIMER_COUNT];
+    uint64_t timerCalls[PROBE_TIMER_COUNT];
+} ProbeThreadData;
+
+typedef struct {
+    ProbeThreadData totals;
+    int threads;
+    bool hardwareAvailable;
+    uint64_t hardware[PROBE_HW_COUNT];
+} ProbeReport;
+
+typedef struct {
+    ProbeTimer timer;
+    uint64_t start;
+} ProbeScope;
+
+extern _Thread_local ProbeThreadData *probe_local;
+
+ProbeThreadData *probe_register_thread(void);
+void probe_reset(void);
+void probe_snapshot(ProbeReport *report);
+void probe_report(FILE *out);
+bool probe_hw_start(void);
+void probe_hw_stop(void);
+const char *probe_counter_name(ProbeCounter counter);
+const char *probe_timer_name(ProbeTimer timer);
+
+// Cheapest monotonic tick source available: TSC on x86, the virtual counter
+// on AArch64, nanoseconds elsewhere
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t probe_cycles(void) { return __rdtsc(); }
+#elif defined(__aarch64__)
+static inline uint64_t probe_cycles(void) {
+    uint64_t value;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+}
+#else
+#include <time.h>
+static inline uint64_t probe_cycles(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+#endif
+
+static inline ProbeThreadData *probe_thread_data(void) {
+    return probe_local ? probe_local : probe_register_thread();
+}
+
+static inline void probe_scope_end(ProbeScope *scope) {
+    ProbeThreadData *data = probe_thread_data();
+    data->timerCycles[scope->timer] += probe_cycles() - scope->start;
+    data->timerCalls[scope->timer]++;
+}
+
+#ifdef PROBES_ENABLED
+#define PROBE_COUNT(counter, amount) (probe_thread_data()->counters[(counter)] += (amount))
+// Times the rest of the enclosing block
+#define PROBE_SCOPE(timer) \
+    ProbeScope probe_scope_##timer __attribute__((cleanup(probe_scope_end))) = {(timer), probe_cycles()}
+#define PROBE_HW_START() probe_hw_start()
+#define PROBE_HW_STOP() probe_hw_stop()
+#define PROBE_REPORT() probe_report(stderr)
+#else
+#define PROBE_COUNT(counter, amount) ((void)0)
+#define PROBE_SCOPE(timer) ((void)0)
+#define PROBE_HW_START() ((void)0)
+#define PROBE_HW_STOP() ((void)0)
+#define PROBE_REPORT() ((void)0)
+#endif
+
+#endif
@@ -2,204 +2,403 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <stdint.h>
+#include "msv.h"
+#include "psv.h"
+#include "evlog.h"
+#include "probe.h"
+#include "workload.h"
 
 #define MAX_PROCESSES 100
 
-typedef struct {
-    int process_id;
-    int arrival_time;
-    int burst_time;
-    int priority;
-    int remaining_time;
-    int completion_time;
-    int waiting_time;
-    int turnaround_time;
-} Process;
+// Append an execution step and record it as a dispatch event
+static void add_step(ExecutionStep steps[], int *step_count, int process_id, int start_time, int duration) {
+    steps[*step_count].process_id = process_id;
+    steps[*step_count].start_time = start_time;
+    steps[*step_count].duration = duration;
+    (*step_count)++;
+    EVLOG(ENGINE_PSV, EVENT_DISPATCH, process_id, start_time, duration);
+    PROBE_COUNT(PROBE_PSV_DISPATCHES, 1);
+}
 
-typedef struct {
-    int process_id;
-    int start_time;
-    int duration;
-} ExecutionStep;
-
-// Function prototypes
-void fcfs(Process processes[], int n, ExecutionStep steps[], int *step_count);
-void sjf(Process processes[], int n, ExecutionStep steps[], int *step_count);
-void priority_scheduling(Process processes[], int n, ExecutionStep steps[], int *step_count);
-void round_robin(Process processes[], int n, int quantum, ExecutionStep steps[], int *step_count);
-void sort_by_arrival(Process processes[], int n);
-void sort_by_burst_time(Process processes[], int n);
-void sort_by_priority(Process processes[], int n);
-
-// First Come First Serve
-void fcfs(Process processes[], int n, ExecutionStep steps[], int *step_count) {
-    sort_by_arrival(processes, n);
-    int current_time = 0;
+// Fill in a finished process's completion, turnaround and waiting times
+static void record_completion(Process *process, int completion_time) {
+    process->completion_time = completion_time;
+    process->turnaround_time = completion_time - process->arrival_time;
+    process->waiting_time = process->turnaround_time - process->burst_time;
+}
+
+// First Come First Serve. Leaves processes sorted by arrival time (stable).
+// Like the other schedulers, returns false if scratch space runs out.
+bool fcfs(Process processes[], int n, ExecutionStep steps[], int *step_count) {
+    PROBE_SCOPE(PROBE_TIMER_SCHEDULE);
     *step_count = 0;
+    if (!sort_by_arrival(processes, n))
+        return false;
+    int current_time = 0;
 
     for (int i = 0; i < n; i++) {
         if (current_time < processes[i].arrival_time) {
+            PROBE_COUNT(PROBE_PSV_IDLE_TICKS, processes[i].arrival_time - current_time);
             current_time = processes[i].arrival_time;
         }
 
-        steps[*step_count].process_id = processes[i].process_id;
-        steps[*step_count].start_time = current_time;
-        steps[*step_count].duration = processes[i].burst_time;
-        (*step_count)++;
+        add_step(steps, step_count, processes[i].process_id, current_time, processes[i].burst_time);
 
         current_time += processes[i].burst_time;
-        processes[i].completion_time = current_time;
-        processes[i].turnaround_time = processes[i].completion_time - processes[i].arrival_time;
-        processes[i].waiting_time = processes[i].turnaround_time - processes[i].burst_time;
+        record_completion(&processes[i], current_time);
     }
+    return true;
 }
 
-// Shortest Job First (Non-preemptive)
-void sjf(Process processes[], int n, ExecutionStep steps[], int *step_count) {
-    Process temp[MAX_PROCESSES];
-    memcpy(temp, processes, n * sizeof(Process));
-    int current_time = 0;
-    int completed = 0;
-    *step_count = 0;
+// Indices of processes in arrival order; equal arrivals keep index order
+static int *arrival_order(const Process processes[], int n) {
+    KeyIndex *pairs = (KeyIndex*)malloc((n ? n : 1) * sizeof(KeyIndex));
+    int *order = (int*)malloc((n ? n : 1) * sizeof(int));
+    bool sorted = pairs != NULL && order != NULL;
+    if (sorted) {
+        for (int i = 0; i < n; i++)
+            pairs[i] = (KeyIndex){processes[i].arrival_time, (size_t)i};
+        sorted = sortKeyIndex(pairs, n, true);
+    }
+    if (sorted) {
+        for (int i = 0; i < n; i++)
+            order[i] = (int)pairs[i].index;
+    } else {
+        free(order);
+        order = NULL;
+    }
+    free(pairs);
+    return order;
+}
 
-    while (completed < n) {
-        int shortest_job = -1;
-        int min_burst = INT_MAX;
-
-        for (int i = 0; i < n; i++) {
-            if (temp[i].arrival_time <= current_time && temp[i].remaining_time > 0) {
-                if (temp[i].burst_time < min_burst) {
-                    min_burst = temp[i].burst_time;
-                    shortest_job = i;
-                }
-            }
-        }
+typedef int (*ProcessKey)(const Process *process);
 
-        if (shortest_job == -1) {
-            current_time++;
-            continue;
-        }
+static int burst_time_of(const Process *process) {
+    return process->burst_time;
+}
 
-        steps[*step_count].process_id = temp[shortest_job].process_id;
-        steps[*step_count].start_time = current_time;
-        steps[*step_count].duration = temp[shortest_job].burst_time;
-        (*step_count)++;
+static int priority_of(const Process *process) {
+    return process->priority;
+}
 
-        current_time += temp[shortest_job].burst_time;
-        temp[shortest_job].remaining_time = 0;
-        completed++;
+// Ready-queue order: smallest key first, then lowest index
+static bool ready_before(const Process processes[], ProcessKey key, int a, int b) {
+    int key_a = key(&processes[a]);
+    int key_b = key(&processes[b]);
+    return key_a < key_b || (key_a == key_b && a < b);
+}
+
+static void ready_push(int heap[], int *size, int index, const Process processes[], ProcessKey key) {
+    int at = (*size)++;
+    while (at > 0 && ready_before(processes, key, index, heap[(at - 1) / 2])) {
+        heap[at] = heap[(at - 1) / 2];
+        at = (at - 1) / 2;
     }
+    heap[at] = index;
 }
 
-// Priority Scheduling (Non-preemptive)
-void priority_scheduling(Process processes[], int n, ExecutionStep steps[], int *step_count) {
-    Process temp[MAX_PROCESSES];
-    memcpy(temp, processes, n * sizeof(Process));
-    int current_time = 0;
-    int completed = 0;
-    *step_count = 0;
+static int ready_pop(int heap[], int *size, const Process processes[], ProcessKey key) {
+    int top = heap[0];
+    int last = heap[--(*size)];
+    int at = 0;
+    while (1) {
+        int child = 2 * at + 1;
+        if (child >= *size) break;
+        if (child + 1 < *size && ready_before(processes, key, heap[child + 1], heap[child])) child++;
+        if (!ready_before(processes, key, heap[child], last)) break;
+        heap[at] = heap[child];
+        at = child;
+    }
+    if (*size > 0) heap[at] = last;
+    return top;
+}
 
-    while (completed < n) {
-        int highest_priority = -1;
-        int min_priority = INT_MAX;
-
-        for (int i = 0; i < n; i++) {
-            if (temp[i].arrival_time <= current_time && temp[i].remaining_time > 0) {
-                if (temp[i].priority < min_priority) {
-                    min_priority = temp[i].priority;
-                    highest_priority = i;
-                }
-            }
-        }
+// Non-preemptive scheduling by key: whenever the CPU is free, run the
+// arrived process with the smallest key (lowest index on ties) to completion,
+// idling until the next arrival when none is ready. Arrivals are admitted in
+// arrival order into a heap, so a run costs O(n log n). Completion metrics
+// are written back to processes in their input order.
+static bool schedule_by_key(Process processes[], int n, ProcessKey key, ExecutionStep steps[], int *step_count) {
+    *step_count = 0;
+    int *order = arrival_order(processes, n);
+    int *heap = (int*)malloc((n ? n : 1) * sizeof(int));
+    if (order == NULL || heap == NULL) {
+        free(order);
+        free(heap);
+        return false;
+    }
 
-        if (highest_priority == -1) {
-            current_time++;
+    int current_time = 0;
+    int next = 0;
+    int ready = 0;
+    for (int completed = 0; completed < n;) {
+        while (next < n && processes[order[next]].arrival_time <= current_time)
+            ready_push(heap, &ready, order[next++], processes, key);
+
+        if (ready == 0) {
+            PROBE_COUNT(PROBE_PSV_IDLE_TICKS, processes[order[next]].arrival_time - current_time);
+            current_time = processes[order[next]].arrival_time;
             continue;
         }
 
-        steps[*step_count].process_id = temp[highest_priority].process_id;
-        steps[*step_count].start_time = current_time;
-        steps[*step_count].duration = temp[highest_priority].burst_time;
-        (*step_count)++;
-
-        current_time += temp[highest_priority].burst_time;
-        temp[highest_priority].remaining_time = 0;
+        int chosen = ready_pop(heap, &ready, processes, key);
+        add_step(steps, step_count, processes[chosen].process_id, current_time, processes[chosen].burst_time);
+        current_time += processes[chosen].burst_time;
+        record_completion(&processes[chosen], current_time);
         completed++;
     }
+
+    free(order);
+    free(heap);
+    return true;
 }
 
-// Round Robin
-void round_robin(Process processes[], int n, int quantum, ExecutionStep steps[], int *step_count) {
-    Process temp[MAX_PROCESSES];
-    memcpy(temp, processes, n * sizeof(Process));
-    int current_time = 0;
-    int completed = 0;
-    *step_count = 0;
+// Shortest Job First (Non-preemptive)
+bool sjf(Process processes[], int n, ExecutionStep steps[], int *step_count) {
+    PROBE_SCOPE(PROBE_TIMER_SCHEDULE);
+    return schedule_by_key(processes, n, burst_time_of, steps, step_count);
+}
 
-    while (completed < n) {
-        int flag = 0;
-        for (int i = 0; i < n; i++) {
-            if (temp[i].remaining_time > 0 && temp[i].arrival_time <= current_time) {
-                flag = 1;
-                int execution_time = (temp[i].remaining_time < quantum) ? 
-                                   temp[i].remaining_time : quantum;
-
-                steps[*step_count].process_id = temp[i].process_id;
-                steps[*step_count].start_time = current_time;
-                steps[*step_count].duration = execution_time;
-                (*step_count)++;
-
-                temp[i].remaining_time -= execution_time;
-                current_time += execution_time;
-
-                if (temp[i].remaining_time == 0) {
-                    completed++;
-                }
-            }
-        }
-        if (!flag) current_time++;
+// Priority Scheduling (Non-preemptive); lower values run first
+bool priority_scheduling(Process processes[], int n, ExecutionStep steps[], int *step_count) {
+    PROBE_SCOPE(PROBE_TIMER_SCHEDULE);
+    return schedule_by_key(processes, n, priority_of, steps, step_count);
+}
+
+// Set of process indices with a 64-way summary bit per word above each
+// level, so finding the next member at or after an index is O(log64 n)
+#define READY_SET_MAX_LEVELS 6
+
+typedef struct {
+    uint64_t *words[READY_SET_MAX_LEVELS];
+    int counts[READY_SET_MAX_LEVELS];
+    int levels;
+    uint64_t *storage;
+} ReadySet;
+
+static bool ready_set_init(ReadySet *set, int n) {
+    int total = 0;
+    int bits = n ? n : 1;
+    set->levels = 0;
+    do {
+        int count = (bits + 63) / 64;
+        set->counts[set->levels++] = count;
+        total += count;
+        bits = count;
+    } while (bits > 1);
+
+    set->storage = (uint64_t*)calloc(total, sizeof(uint64_t));
+    if (set->storage == NULL) return false;
+    uint64_t *words = set->storage;
+    for (int level = 0; level < set->levels; level++) {
+        set->words[level] = words;
+        words += set->counts[level];
     }
+    return true;
 }
 
-// Utility functions
-void sort_by_arrival(Process processes[], int n) {
-    for (int i = 0; i < n - 1; i++) {
-        for (int j = 0; j < n - i - 1; j++) {
-            if (processes[j].arrival_time > processes[j + 1].arrival_time) {
-                Process temp = processes[j];
-                processes[j] = processes[j + 1];
-                processes[j + 1] = temp;
-            }
-        }
+static void ready_set_insert(ReadySet *set, int index) {
+    for (int level = 0; level < set->levels; level++) {
+        set->words[level][index / 64] |= 1ULL << (index % 64);
+        index /= 64;
     }
 }
 
-void sort_by_burst_time(Process processes[], int n) {
-    for (int i = 0; i < n - 1; i++) {
-        for (int j = 0; j < n - i - 1; j++) {
-            if (processes[j].burst_time > processes[j + 1].burst_time) {
-                Process temp = processes[j];
-                processes[j] = processes[j + 1];
-                processes[j + 1] = temp;
-            }
+static void ready_set_remove(ReadySet *set, int index) {
+    for (int level = 0; level < set->levels; level++) {
+        set->words[level][index / 64] &= ~(1ULL << (index % 64));
+        if (set->words[level][index / 64] != 0) return;
+        index /= 64;
+    }
+}
+
+// Smallest member >= from, or -1
+static int ready_set_next(const ReadySet *set, int from) {
+    int level = 0;
+    long long index = from;
+    while (1) {
+        if (level == set->levels || index / 64 >= set->counts[level]) return -1;
+        uint64_t word = set->words[level][index / 64] & (~0ULL << (index % 64));
+        if (word != 0) {
+            index = (index & ~63LL) + __builtin_ctzll(word);
+            break;
         }
+        index = index / 64 + 1;
+        level++;
     }
+    while (level-- > 0)
+        index = index * 64 + __builtin_ctzll(set->words[level][index]);
+    return (int)index;
 }
 
-void sort_by_priority(Process processes[], int n) {
-    for (int i = 0; i < n - 1; i++) {
-        for (int j = 0; j < n - i - 1; j++) {
-            if (processes[j].priority > processes[j + 1].priority) {
-                Process temp = processes[j];
-                processes[j] = processes[j + 1];
-                processes[j + 1] = temp;
+// Round Robin, with metrics written back as in sjf; quantum must be positive.
+// Passes visit arrived, unfinished processes in index order, each getting a
+// slice of up to quantum ticks; a process that arrives during a pass runs in
+// it if its index is still ahead. A pass that finds nothing idles until the
+// next arrival.
+bool round_robin(Process processes[], int n, int quantum, ExecutionStep steps[], int *step_count) {
+    PROBE_SCOPE(PROBE_TIMER_SCHEDULE);
+    *step_count = 0;
+    if (quantum <= 0) return false;
+
+    int *order = arrival_order(processes, n);
+    int *remaining = (int*)malloc((n ? n : 1) * sizeof(int));
+    ReadySet ready = {0};
+    if (order == NULL || remaining == NULL || !ready_set_init(&ready, n)) {
+        free(order);
+        free(remaining);
+        return false;
+    }
+    for (int i = 0; i < n; i++)
+        remaining[i] = processes[i].burst_time;
+
+    int current_time = 0;
+    int next = 0;
+    int completed = 0;
+    int position = 0;
+    bool ran = false;
+    while (completed < n) {
+        while (next < n && processes[order[next]].arrival_time <= current_time)
+            ready_set_insert(&ready, order[next++]);
+
+        int i = ready_set_next(&ready, position);
+        if (i < 0) {
+            if (!ran) {
+                PROBE_COUNT(PROBE_PSV_IDLE_TICKS, processes[order[next]].arrival_time - current_time);
+                current_time = processes[order[next]].arrival_time;
             }
+            position = 0;
+            ran = false;
+            continue;
+        }
+
+        int execution_time = remaining[i] < quantum ? remaining[i] : quantum;
+        add_step(steps, step_count, processes[i].process_id, current_time, execution_time);
+        remaining[i] -= execution_time;
+        current_time += execution_time;
+
+        if (remaining[i] == 0) {
+            ready_set_remove(&ready, i);
+            record_completion(&processes[i], current_time);
+            completed++;
         }
+        position = i + 1;
+        ran = true;
     }
+
+    free(order);
+    free(remaining);
+    free(ready.storage);
+    return true;
+}
+
+// Utility functions
+static long long arrival_key(const void *record) {
+    return ((const Process*)record)->arrival_time;
+}
+
+static long long burst_time_key(const void *record) {
+    return ((const Process*)record)->burst_time;
+}
+
+static long long priority_key(const void *record) {
+    return ((const Process*)record)->priority;
+}
+
+// Stable sorts keep processes with equal keys in their original order.
+// They return false, leaving the array unchanged, if scratch space runs out.
+bool sort_by_arrival(Process processes[], int n) {
+    return sortRecords(processes, n, sizeof(Process), arrival_key, true);
+}
+
+bool sort_by_burst_time(Process processes[], int n) {
+    return sortRecords(processes, n, sizeof(Process), burst_time_key, true);
+}
+
+bool sort_by_priority(Process processes[], int n) {
+    return sortRecords(processes, n, sizeof(Process), priority_key, true);
+}
+
+#ifndef PSV_NO_MAIN
+// Schedule a generated job file: psv --workload FILE [--algorithm fcfs|sjf|priority|robin] [--quantum Q]
+static int run_workload(int argc, char *argv[]) {
+    const char *algorithm = "fcfs";
+    int quantum = 2;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--algorithm") == 0) algorithm = argv[i + 1];
+        else if (strcmp(argv[i], "--quantum") == 0) quantum = atoi(argv[i + 1]);
+    }
+    if (quantum < 1) quantum = 1;
+
+    WorkloadFileHeader header;
+    WorkloadJob *jobs = workload_load_jobs(argv[2], &header);
+    if (jobs == NULL || header.count > INT_MAX) {
+        fprintf(stderr, "Cannot read job workload %s\n", argv[2]);
+        free(jobs);
+        return 1;
+    }
+
+    int n = (int)header.count;
+    Process *processes = (Process*)malloc((n ? n : 1) * sizeof(Process));
+    if (processes == NULL) {
+        fprintf(stderr, "Cannot allocate %d processes\n", n);
+        free(jobs);
+        return 1;
+    }
+    long long max_steps = n;
+    for (int i = 0; i < n; i++) {
+        processes[i] = (Process){jobs[i].id, jobs[i].arrival, jobs[i].burst, jobs[i].priority,
+                                 jobs[i].burst, 0, 0, 0};
+        if (strcmp(algorithm, "robin") == 0) max_steps += (jobs[i].burst - 1) / quantum;
+    }
+    free(jobs);
+    ExecutionStep *steps = max_steps <= INT_MAX
+                           ? (ExecutionStep*)malloc((max_steps ? max_steps : 1) * sizeof(ExecutionStep)) : NULL;
+    if (steps == NULL) {
+        fprintf(stderr, "Cannot allocate %lld execution steps\n", max_steps);
+        free(steps);
+        free(processes);
+        return 1;
+    }
+    int step_count = 0;
+
+    EVLOG_START_FROM_ENV();
+    PROBE_HW_START();
+
+    bool scheduled;
+    if (strcmp(algorithm, "sjf") == 0) scheduled = sjf(processes, n, steps, &step_count);
+    else if (strcmp(algorithm, "priority") == 0) scheduled = priority_scheduling(processes, n, steps, &step_count);
+    else if (strcmp(algorithm, "robin") == 0) scheduled = round_robin(processes, n, quantum, steps, &step_count);
+    else scheduled = fcfs(processes, n, steps, &step_count);
+
+    PROBE_HW_STOP();
+    PROBE_REPORT();
+    EVLOG_STOP();
+
+    if (!scheduled) {
+        fprintf(stderr, "Out of memory scheduling %d processes (%s)\n", n, algorithm);
+        free(steps);
+        free(processes);
+        return 1;
+    }
+
+    long long busy = 0;
+    for (int i = 0; i < step_count; i++) busy += steps[i].duration;
+    int makespan = step_count ? steps[step_count - 1].start_time + steps[step_count - 1].duration : 0;
+    printf("Scheduled %d processes (%s) in %d steps\n", n, algorithm, step_count);
+    printf("Makespan: %d, CPU utilization: %.2f%%\n", makespan, makespan ? 100.0 * busy / makespan : 0.0);
+
+    free(steps);
+    free(processes);
+    return 0;
 }
 
 // Example main function to demonstrate usage
-int main() {
+int main(int argc, char *argv[]) {
+    if (argc >= 3 && strcmp(argv[1], "--workload") == 0)
+        return run_workload(argc, argv);
+
     Process processes[MAX_PROCESSES];
     ExecutionStep steps[MAX_PROCESSES * 2];  // Extra space for RR algorithm
     int step_count = 0;
@@ -210,12 +409,20 @@ int main() {
     processes[1] = (Process){2, 1, 3, 1, 3, 0, 0, 0};
     processes[2] = (Process){3, 2, 2, 3, 2, 0, 0, 0};
 
+    // Record step events to $EVLOG_PATH (builds with EVLOG_ENABLED)
+    EVLOG_START_FROM_ENV();
+    PROBE_HW_START();
+
     // Example usage of different algorithms
     // fcfs(processes, n, steps, &step_count);
     // sjf(processes, n, steps, &step_count);
     // priority_scheduling(processes, n, steps, &step_count);
     round_robin(processes, n, 2, steps, &step_count);  // quantum = 2
 
+    PROBE_HW_STOP();
+    PROBE_REPORT();
+    EVLOG_STOP();
+
     // Print results
     printf("Execution Steps:\n");
     for (int i = 0; i < step_count; i++) {
@@ -224,4 +431,5 @@ int main() {
     }
 
     return 0;
-}
\ No newline at end of file
+}
+#endif
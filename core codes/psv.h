@@ -0,0 +1,32 @@
+#ifndef PSV_H
+#define PSV_H
+
+#include <stdbool.h>
+
+typedef struct {
+    int process_id;
+    int arrival_time;
+    int burst_time;
+    int priority;
+    int remaining_time;
+    int completion_time;
+    int waiting_time;
+    int turnaround_time;
+} Process;
+
+typedef struct {
+    int process_id;
+    int start_time;
+    int duration;
+} ExecutionStep;
+
+// Function prototypes
+bool fcfs(Process processes[], int n, ExecutionStep steps[], int *step_count);
+bool sjf(Process processes[], int n, ExecutionStep steps[], int *step_count);
+bool priority_scheduling(Process processes[], int n, ExecutionStep steps[], int *step_count);
+bool round_robin(Process processes[], int n, int quantum, ExecutionStep steps[], int *step_count);
+bool sort_by_arrival(Process processes[], int n);
+bool sort_by_burst_time(Process processes[], int n);
+bool sort_by_priority(Process processes[], int n);
+
+#endif
@@ -0,0 +1,95 @@
+#include <stdlib.h>
+#include "psv.h"
+#include "wasm.h"
+
+// WebAssembly exports for the process scheduler. Input is n records of four
+// ints (process_id, arrival_time, burst_time, priority); burst times must be
+// positive. Results stay in module memory and are read through typed-array
+// views:
+//   psv_steps()     -> step_count x {process_id, start_time, duration}
+//   psv_processes() -> n x Process (8 ints). Every algorithm fills in
+//                      completion, waiting and turnaround times. FCFS leaves
+//                      the records sorted by arrival time (stable); the others
+//                      keep input order. remaining_time holds the burst time.
+
+_Static_assert(sizeof(ExecutionStep) == 3 * sizeof(int), "ExecutionStep must be 3 packed ints");
+_Static_assert(sizeof(Process) == 8 * sizeof(int), "Process must be 8 packed ints");
+
+enum {
+    WASM_SCHEDULE_FCFS,
+    WASM_SCHEDULE_SJF,
+    WASM_SCHEDULE_PRIORITY,
+    WASM_SCHEDULE_ROUND_ROBIN
+};
+
+static Process *process_buffer = NULL;
+static int process_capacity = 0;
+static ExecutionStep *step_buffer = NULL;
+static long long step_capacity = 0;
+static int step_count = 0;
+
+// Returns the step count, or -1 for an unknown algorithm, a round-robin
+// quantum that is not positive, a burst time that is not positive (the
+// schedulers would never finish it), or when memory runs out
+WASM_EXPORT int psv_schedule(int algorithm, const int *records, int n, int quantum) {
+    for (int i = 0; i < n; i++) {
+        if (records[4 * i + 2] <= 0) return -1;
+    }
+
+    if (n > process_capacity) {
+        free(process_buffer);
+        process_buffer = (Process*)malloc(n * sizeof(Process));
+        process_capacity = process_buffer ? n : 0;
+        if (process_buffer == NULL) return -1;
+    }
+
+    // Round robin emits one step per quantum slice; the others one per process
+    long long steps_needed = n;
+    for (int i = 0; i < n; i++) {
+        Process *process = &process_buffer[i];
+        process->process_id = records[4 * i];
+        process->arrival_time = records[4 * i + 1];
+        process->burst_time = records[4 * i + 2];
+        process->priority = records[4 * i + 3];
+        process->remaining_time = process->burst_time;
+        process->completion_time = 0;
+        process->waiting_time = 0;
+        process->turnaround_time = 0;
+
+        if (algorithm == WASM_SCHEDULE_ROUND_ROBIN && quantum > 0)
+            steps_needed += process->burst_time / quantum;
+    }
+
+    if (steps_needed > step_capacity) {
+        free(step_buffer);
+        step_buffer = (ExecutionStep*)malloc(steps_needed * sizeof(ExecutionStep));
+        step_capacity = step_buffer ? steps_needed : 0;
+        if (step_buffer == NULL) return -1;
+    }
+
+    step_count = 0;
+    bool scheduled = false;
+    switch (algorithm) {
+        case WASM_SCHEDULE_FCFS:
+            scheduled = fcfs(process_buffer, n, step_buffer, &step_count);
+            break;
+        case WASM_SCHEDULE_SJF:
+            scheduled = sjf(process_buffer, n, step_buffer, &step_count);
+            break;
+        case WASM_SCHEDULE_PRIORITY:
+            scheduled = priority_scheduling(process_buffer, n, step_buffer, &step_count);
+            break;
+        case WASM_SCHEDULE_ROUND_ROBIN:
+            scheduled = round_robin(process_buffer, n, quantum, step_buffer, &step_count);
+            break;
+    }
+    return scheduled ? step_count : -1;
+}
+
+WASM_EXPORT ExecutionStep *psv_steps(void) {
+    return step_buffer;
+}
+
+WASM_EXPORT Process *psv_processes(void) {
+    return process_buffer;
+}
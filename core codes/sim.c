@@ -0,0 +1,643 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include "sim.h"
+#include "evlog.h"
+#include "probe.h"
+
+// ---- Ready queues -------------------------------------------------------
+
+// Every built-in policy is a min-heap on (key, arrival order); FCFS and
+// round robin differ only in the key and quantum
+typedef struct {
+    int64_t key;
+    uint64_t sequence;
+    int index;
+} ReadyEntry;
+
+typedef struct {
+    SimPolicy policy;
+    ReadyEntry *entries;
+    int count;
+    int capacity;
+    uint64_t sequence;
+} ReadyQueue;
+
+static bool ready_before(const ReadyEntry *a, const ReadyEntry *b) {
+    return a->key < b->key || (a->key == b->key && a->sequence < b->sequence);
+}
+
+static void ready_enqueue(SimScheduler *self, const SimProcess *process, int index) {
+    ReadyQueue *queue = (ReadyQueue*)self->state;
+    if (queue->count == queue->capacity) {
+        queue->capacity = queue->capacity ? queue->capacity * 2 : 1024;
+        queue->entries = (ReadyEntry*)realloc(queue->entries, queue->capacity * sizeof(ReadyEntry));
+    }
+
+    ReadyEntry entry = {0, queue->sequence++, index};
+    switch (queue->policy) {
+        case SIM_FCFS: entry.key = process->job.arrival; break;
+        case SIM_SJF: entry.key = process->remaining; break;
+        case SIM_PRIORITY: entry.key = process->job.priority; break;
+        case SIM_ROUND_ROBIN: break;
+    }
+
+    int i = queue->count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!ready_before(&entry, &queue->entries[parent])) break;
+        queue->entries[i] = queue->entries[parent];
+        i = parent;
+    }
+    queue->entries[i] = entry;
+}
+
+static int ready_dequeue(SimScheduler *self) {
+    ReadyQueue *queue = (ReadyQueue*)self->state;
+    if (queue->count == 0) return -1;
+
+    int index = queue->entries[0].index;
+    ReadyEntry last = queue->entries[--queue->count];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= queue->count) break;
+        if (child + 1 < queue->count && ready_before(&queue->entries[child + 1], &queue->entries[child])) child++;
+        if (!ready_before(&queue->entries[child], &last)) break;
+        queue->entries[i] = queue->entries[child];
+        i = child;
+    }
+    queue->entries[i] = last;
+    return index;
+}
+
+static void ready_destroy(SimScheduler *self) {
+    ReadyQueue *queue = (ReadyQueue*)self->state;
+    free(queue->entries);
+    free(queue);
+}
+
+SimScheduler *sim_scheduler_create(SimPolicy policy, int quantum) {
+    static const char *names[] = {"fcfs", "sjf", "priority", "robin"};
+    SimScheduler *scheduler = (SimScheduler*)calloc(1, sizeof(SimScheduler));
+    ReadyQueue *queue = (ReadyQueue*)calloc(1, sizeof(ReadyQueue));
+    queue->policy = policy;
+
+    scheduler->name = names[policy];
+    scheduler->quantum = policy == SIM_ROUND_ROBIN && quantum < 1 ? 1 : quantum;
+    scheduler->enqueue = ready_enqueue;
+    scheduler->dequeue = ready_dequeue;
+    scheduler->destroy = ready_destroy;
+    scheduler->state = queue;
+    return scheduler;
+}
+
+void sim_scheduler_destroy(SimScheduler *scheduler) {
+    if (scheduler == NULL) return;
+    if (scheduler->destroy) scheduler->destroy(scheduler);
+    free(scheduler);
+}
+
+// ---- Event heap ---------------------------------------------------------
+
+static bool event_before(const SimEvent *a, const SimEvent *b) {
+    return a->time < b->time || (a->time == b->time && a->sequence < b->sequence);
+}
+
+static void push_event(Sim *sim, int64_t time, SimEventType type, int process) {
+    if (sim->eventCount == sim->eventCapacity) {
+        sim->eventCapacity = sim->eventCapacity ? sim->eventCapacity * 2 : 1024;
+        sim->events = (SimEvent*)realloc(sim->events, sim->eventCapacity * sizeof(SimEvent));
+    }
+
+    SimEvent event = {time, sim->sequence++, type, process};
+    int i = sim->eventCount++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!event_before(&event, &sim->events[parent])) break;
+        sim->events[i] = sim->events[parent];
+        i = parent;
+    }
+    sim->events[i] = event;
+}
+
+static SimEvent pop_event(Sim *sim) {
+    SimEvent top = sim->events[0];
+    SimEvent last = sim->events[--sim->eventCount];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= sim->eventCount) break;
+        if (child + 1 < sim->eventCount && event_before(&sim->events[child + 1], &sim->events[child])) child++;
+        if (!event_before(&sim->events[child], &last)) break;
+        sim->events[i] = sim->events[child];
+        i = child;
+    }
+    sim->events[i] = last;
+    return top;
+}
+
+// ---- Process slots and wait queues --------------------------------------
+
+static int allocate_slot(Sim *sim) {
+    if (sim->freeList < 0) {
+        int old = sim->processCapacity;
+        sim->processCapacity = old ? old * 2 : 1024;
+        sim->processes = (SimProcess*)realloc(sim->processes, sim->processCapacity * sizeof(SimProcess));
+        for (int i = sim->processCapacity - 1; i >= old; i--) {
+            sim->processes[i].next = sim->freeList;
+            sim->freeList = i;
+        }
+    }
+    int slot = sim->freeList;
+    sim->freeList = sim->processes[slot].next;
+    return slot;
+}
+
+static void release_slot(Sim *sim, int slot) {
+    sim->processes[slot].state = SIM_DONE;
+    sim->processes[slot].next = sim->freeList;
+    sim->freeList = slot;
+}
+
+static void queue_push(Sim *sim, int *head, int *tail, int index) {
+    sim->processes[index].next = -1;
+    if (*tail < 0) *head = index;
+    else sim->processes[*tail].next = index;
+    *tail = index;
+}
+
+static int queue_pop(Sim *sim, int *head, int *tail) {
+    int index = *head;
+    *head = sim->processes[index].next;
+    if (*head < 0) *tail = -1;
+    return index;
+}
+
+static void histogram_add(SimHistogram *histogram, int64_t value) {
+    uint64_t v = value < 0 ? 0 : (uint64_t)value;
+    int bucket;
+    if (v < 16) {
+        bucket = (int)v;
+    } else {
+        int exponent = 63 - __builtin_clzll(v);
+        bucket = (exponent - 3) * 16 + (int)((v >> (exponent - 4)) & 15);
+    }
+    histogram->counts[bucket]++;
+    histogram->total++;
+    histogram->sum += (double)v;
+}
+
+// Lower bound of the bucket holding the given fraction of samples
+uint64_t sim_percentile(const SimHistogram *histogram, double fraction) {
+    if (histogram->total == 0) return 0;
+    uint64_t target = (uint64_t)(fraction * (histogram->total - 1)) + 1;
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < SIM_HISTOGRAM_BUCKETS; bucket++) {
+        seen += histogram->counts[bucket];
+        if (seen >= target) {
+            if (bucket < 16) return bucket;
+            int exponent = bucket / 16 + 3;
+            return (uint64_t)(16 + bucket % 16) << (exponent - 4);
+        }
+    }
+    return 0;
+}
+
+// ---- Job source ---------------------------------------------------------
+
+static WorkloadJob *next_job(Sim *sim) {
+    if (sim->jobNext == sim->jobCount) {
+        sim->jobNext = 0;
+        sim->jobCount = 0;
+        if (sim->file != NULL) {
+            sim->jobCount = fread(sim->jobs, sizeof(WorkloadJob), WORKLOAD_CHUNK, sim->file);
+        } else if (sim->generated < sim->params.count) {
+            uint64_t left = sim->params.count - sim->generated;
+            sim->jobCount = left < WORKLOAD_CHUNK ? (size_t)left : WORKLOAD_CHUNK;
+            workload_fill_jobs(sim->jobs, sim->generated, sim->jobCount, &sim->params, &sim->clock);
+            sim->generated += sim->jobCount;
+        }
+        if (sim->jobCount == 0) return NULL;
+    }
+    return &sim->jobs[sim->jobNext++];
+}
+
+// Only the next arrival is ever queued, so the heap holds at most one event
+// per in-flight job plus one, however long the workload
+static void schedule_next_arrival(Sim *sim) {
+    WorkloadJob *job = next_job(sim);
+    if (job == NULL) return;
+
+    int slot = allocate_slot(sim);
+    SimProcess *process = &sim->processes[slot];
+    memset(process, 0, sizeof(*process));
+    process->job = *job;
+    process->next = -1;
+    push_event(sim, job->arrival, SIM_EVENT_ARRIVAL, slot);
+}
+
+static void set_resources(Sim *sim, int resourceCount) {
+    memset(&sim->banker, 0, sizeof(sim->banker));
+    sim->banker.resourceCount = resourceCount;
+    memcpy(sim->banker.available, sim->config.available, sizeof(int) * resourceCount);
+}
+
+bool sim_open_workload(Sim *sim, const char *path) {
+    WorkloadFileHeader header;
+    sim->file = workload_open(path, WORKLOAD_JOBS, &header);
+    if (sim->file == NULL || header.resourceCount > MAX_RESOURCES) return false;
+
+    set_resources(sim, (int)header.resourceCount);
+    schedule_next_arrival(sim);
+    return true;
+}
+
+void sim_generate_workload(Sim *sim, const WorkloadJobParams *params) {
+    sim->params = *params;
+    set_resources(sim, params->resourceCount);
+    schedule_next_arrival(sim);
+}
+
+// ---- Subsystem requests -------------------------------------------------
+
+static bool try_memory(Sim *sim, SimProcess *process) {
+    Process request = {0};
+    strcpy(request.id, process->name);
+    strcpy(request.name, process->name);
+    request.size = process->job.memory;
+    request.start_time = process->job.arrival;
+    sim->memory->current_time = sim->now < INT_MAX ? (int)sim->now : INT_MAX;
+    return allocate_memory(sim->memory, &request);
+}
+
+// Register the claim and take the first half of it, or leave no trace
+static bool try_admission(Sim *sim, SimProcess *process) {
+    if (sim->banker.processCount == MAX_BANKER_PROCESSES) return false;
+
+    int zero[MAX_RESOURCES] = {0};
+    int request[MAX_RESOURCES];
+    for (int j = 0; j < sim->banker.resourceCount; j++)
+        request[j] = process->requestPending ? (process->job.demand[j] + 1) / 2 : process->job.demand[j];
+
+    addProcess(process->name, zero, process->job.demand, process->job.priority);
+    if (requestResources(process->name, request)) return true;
+    releaseResources(process->name);
+    return false;
+}
+
+static bool try_remaining_request(Sim *sim, SimProcess *process) {
+    int request[MAX_RESOURCES];
+    for (int j = 0; j < sim->banker.resourceCount; j++)
+        request[j] = process->job.demand[j] / 2;
+    return requestResources(process->name, request);
+}
+
+static void make_ready(Sim *sim, int index) {
+    SimProcess *process = &sim->processes[index];
+    process->state = SIM_READY;
+    process->waitStart = sim->now;
+    sim->scheduler->enqueue(sim->scheduler, process, index);
+}
+
+// Memory is held; queue behind earlier jobs or register with the Banker
+static void admit(Sim *sim, int index) {
+    SimProcess *process = &sim->processes[index];
+    if (!process->usesBanker) {
+        make_ready(sim, index);
+        return;
+    }
+
+    if (sim->admissionHead < 0 && try_admission(sim, process)) {
+        make_ready(sim, index);
+        return;
+    }
+    process->state = SIM_WAITING_ADMISSION;
+    process->waitStart = sim->now;
+    queue_push(sim, &sim->admissionHead, &sim->admissionTail, index);
+    sim->stats.admissionBlocks++;
+}
+
+// ---- Event handlers -----------------------------------------------------
+
+static void handle_arrival(Sim *sim, int index) {
+    SimProcess *process = &sim->processes[index];
+    sim->stats.arrived++;
+
+    bool fits = process->job.memory <= sim->config.totalMemory;
+    for (int j = 0; j < sim->banker.resourceCount; j++) {
+        if (process->job.demand[j] > sim->config.available[j]) fits = false;
+        if (process->job.demand[j] > 0) process->usesBanker = true;
+    }
+    if (!fits) {
+        sim->stats.rejected++;
+        release_slot(sim, index);
+        return;
+    }
+
+    snprintf(process->name, sizeof(process->name), "J%d", process->job.id);
+    process->remaining = process->job.burst;
+    process->firstRun = -1;
+
+    // Jobs too short to split, or whose claims are all 1, take everything up front
+    if (process->usesBanker && process->job.burst >= 2) {
+        for (int j = 0; j < sim->banker.resourceCount; j++) {
+            if (process->job.demand[j] / 2 > 0) process->requestPending = true;
+        }
+        process->untilRequest = process->job.burst / 2;
+    }
+
+    if (sim->memoryHead < 0 && try_memory(sim, process)) {
+        admit(sim, index);
+        return;
+    }
+    process->state = SIM_WAITING_MEMORY;
+    process->waitStart = sim->now;
+    queue_push(sim, &sim->memoryHead, &sim->memoryTail, index);
+    sim->stats.memoryBlocks++;
+}
+
+// A completion freed memory and resources: retry blocked requests first
+// (those jobs hold resources), then admissions, then memory, each in FIFO order
+static void wake(Sim *sim) {
+    int previous = -1;
+    for (int index = sim->blockedHead; index >= 0;) {
+        SimProcess *process = &sim->processes[index];
+        int next = process->next;
+        if (try_remaining_request(sim, process)) {
+            if (previous < 0) sim->blockedHead = next;
+            else sim->processes[previous].next = next;
+            if (sim->blockedTail == index) sim->blockedTail = previous;
+            process->requestPending = false;
+            process->resourceWait += sim->now - process->waitStart;
+            make_ready(sim, index);
+            PROBE_COUNT(PROBE_SIM_WAKEUPS, 1);
+        } else {
+            previous = index;
+        }
+        index = next;
+    }
+
+    while (sim->admissionHead >= 0 && try_admission(sim, &sim->processes[sim->admissionHead])) {
+        int index = queue_pop(sim, &sim->admissionHead, &sim->admissionTail);
+        sim->processes[index].resourceWait += sim->now - sim->processes[index].waitStart;
+        make_ready(sim, index);
+        PROBE_COUNT(PROBE_SIM_WAKEUPS, 1);
+    }
+
+    while (sim->memoryHead >= 0 && try_memory(sim, &sim->processes[sim->memoryHead])) {
+        int index = queue_pop(sim, &sim->memoryHead, &sim->memoryTail);
+        sim->processes[index].memoryWait += sim->now - sim->processes[index].waitStart;
+        admit(sim, index);
+        PROBE_COUNT(PROBE_SIM_WAKEUPS, 1);
+    }
+}
+
+static void complete(Sim *sim, int index) {
+    SimProcess *process = &sim->processes[index];
+    if (process->usesBanker) releaseResources(process->name);
+    sim->memory->current_time = sim->now < INT_MAX ? (int)sim->now : INT_MAX;
+    deallocate_process(sim->memory, process->name);
+
+    sim->stats.completed++;
+    sim->stats.makespan = sim->now;
+    histogram_add(&sim->stats.turnaround, sim->now - process->job.arrival);
+    histogram_add(&sim->stats.response, process->firstRun - process->job.arrival);
+    histogram_add(&sim->stats.readyWait, process->readyWait);
+    histogram_add(&sim->stats.memoryWait, process->memoryWait);
+    histogram_add(&sim->stats.resourceWait, process->resourceWait);
+
+    release_slot(sim, index);
+    wake(sim);
+}
+
+static void handle_slice_end(Sim *sim, int index) {
+    SimProcess *process = &sim->processes[index];
+    sim->idleCpus++;
+    process->remaining -= process->slice;
+    if (process->requestPending) process->untilRequest -= process->slice;
+
+    if (process->remaining == 0) {
+        complete(sim, index);
+    } else if (process->requestPending && process->untilRequest == 0) {
+        if (try_remaining_request(sim, process)) {
+            process->requestPending = false;
+            make_ready(sim, index);
+        } else {
+            process->state = SIM_BLOCKED;
+            process->waitStart = sim->now;
+            queue_push(sim, &sim->blockedHead, &sim->blockedTail, index);
+            sim->stats.requestBlocks++;
+        }
+    } else {
+        make_ready(sim, index);
+    }
+}
+
+// Fill idle CPUs from the ready queue
+static void dispatch(Sim *sim) {
+    while (sim->idleCpus > 0) {
+        int index = sim->scheduler->dequeue(sim->scheduler);
+        if (index < 0) break;
+
+        SimProcess *process = &sim->processes[index];
+        process->readyWait += sim->now - process->waitStart;
+        if (process->firstRun < 0) process->firstRun = sim->now;
+
+        int64_t slice = process->remaining;
+        if (sim->scheduler->quantum > 0 && slice > sim->scheduler->quantum) slice = sim->scheduler->quantum;
+        if (process->requestPending && slice > process->untilRequest) slice = process->untilRequest;
+
+        process->slice = slice;
+        process->state = SIM_RUNNING;
+        sim->idleCpus--;
+        sim->stats.dispatches++;
+        sim->stats.busyTicks += slice;
+        push_event(sim, sim->now + slice, SIM_EVENT_SLICE_END, index);
+        EVLOG(ENGINE_SIM, EVENT_DISPATCH, process->job.id, (int32_t)sim->now, (int32_t)slice);
+    }
+}
+
+// ---- Driver -------------------------------------------------------------
+
+bool sim_init(Sim *sim, const SimConfig *config, SimScheduler *scheduler) {
+    memset(sim, 0, sizeof(*sim));
+    sim->config = *config;
+    sim->scheduler = scheduler;
+    sim->freeList = -1;
+    sim->memoryHead = sim->memoryTail = -1;
+    sim->admissionHead = sim->admissionTail = -1;
+    sim->blockedHead = sim->blockedTail = -1;
+    sim->idleCpus = config->cpus > 0 ? config->cpus : 1;
+
+    sim->memory = (MemoryManager*)malloc(sizeof(MemoryManager));
+    sim->jobs = (WorkloadJob*)malloc(WORKLOAD_CHUNK * sizeof(WorkloadJob));
+    if (sim->memory == NULL || sim->jobs == NULL) {
+        sim_free(sim);
+        return false;
+    }
+    init_memory_manager(sim->memory, config->totalMemory);
+    sim->memory->strategy = config->strategy;
+    return true;
+}
+
+// Process events up to and including time until (INT64_MAX runs to the end).
+// The Banker's engine works on this simulation's state for the duration.
+void sim_run(Sim *sim, int64_t until) {
+    PROBE_SCOPE(PROBE_TIMER_SIM_RUN);
+    BankerState *previousState = bankerState;
+    bool previousVerbose = bankerVerbose;
+    bankerState = &sim->banker;
+    bankerVerbose = false;
+
+    while (sim->eventCount > 0 && sim->events[0].time <= until) {
+        SimEvent event = pop_event(sim);
+        sim->now = event.time;
+        sim->stats.events++;
+        PROBE_COUNT(PROBE_SIM_EVENTS, 1);
+
+        if (event.type == SIM_EVENT_ARRIVAL) {
+            handle_arrival(sim, event.process);
+            schedule_next_arrival(sim);
+        } else {
+            handle_slice_end(sim, event.process);
+        }
+        dispatch(sim);
+    }
+
+    bankerState = previousState;
+    bankerVerbose = previousVerbose;
+}
+
+void sim_free(Sim *sim) {
+    if (sim->file != NULL) fclose(sim->file);
+    free(sim->events);
+    free(sim->processes);
+    free(sim->memory);
+    free(sim->jobs);
+    sim->file = NULL;
+    sim->events = NULL;
+    sim->processes = NULL;
+    sim->memory = NULL;
+    sim->jobs = NULL;
+}
+
+static void report_histogram(FILE *out, const char *label, const SimHistogram *histogram) {
+    fprintf(out, "  %-14s mean %10.1f  p50 %8llu  p99 %8llu  p99.9 %8llu\n", label,
+            histogram->total ? histogram->sum / histogram->total : 0.0,
+            (unsigned long long)sim_percentile(histogram, 0.5),
+            (unsigned long long)sim_percentile(histogram, 0.99),
+            (unsigned long long)sim_percentile(histogram, 0.999));
+}
+
+void sim_report(const Sim *sim, FILE *out) {
+    const SimStats *stats = &sim->stats;
+    int cpus = sim->config.cpus > 0 ? sim->config.cpus : 1;
+
+    fprintf(out, "Scheduler: %s (quantum %d), CPUs: %d, memory: %d MB\n",
+            sim->scheduler->name, sim->scheduler->quantum, cpus, sim->config.totalMemory);
+    fprintf(out, "Jobs: %llu arrived, %llu completed, %llu rejected\n",
+            (unsigned long long)stats->arrived, (unsigned long long)stats->completed,
+            (unsigned long long)stats->rejected);
+    fprintf(out, "Events: %llu, dispatches: %llu\n",
+            (unsigned long long)stats->events, (unsigned long long)stats->dispatches);
+    fprintf(out, "Waits: %llu for memory, %llu for admission, %llu mid-burst requests blocked\n",
+            (unsigned long long)stats->memoryBlocks, (unsigned long long)stats->admissionBlocks,
+            (unsigned long long)stats->requestBlocks);
+    fprintf(out, "Makespan: %lld ticks, throughput: %.4f jobs/tick, CPU utilization: %.2f%%\n",
+            (long long)stats->makespan, stats->makespan ? (double)stats->completed / stats->makespan : 0.0,
+            stats->makespan ? 100.0 * stats->busyTicks / ((double)stats->makespan * cpus) : 0.0);
+    fprintf(out, "Latency (ticks):\n");
+    report_histogram(out, "turnaround", &stats->turnaround);
+    report_histogram(out, "response", &stats->response);
+    report_histogram(out, "ready wait", &stats->readyWait);
+    report_histogram(out, "memory wait", &stats->memoryWait);
+    report_histogram(out, "resource wait", &stats->resourceWait);
+}
+
+#ifndef SIM_NO_MAIN
+// Usage: sim [--workload FILE | --count N --rate R --seed S] [--scheduler fcfs|sjf|priority|robin]
+//            [--quantum Q] [--cpus N] [--memory MB] [--strategy first|best|worst|next]
+//            [--available N] [--until T]
+int main(int argc, char *argv[]) {
+    const char *workload = NULL;
+    WorkloadJobParams params;
+    workload_default_job_params(&params);
+    SimConfig config = {4, 4096, FIRST_FIT, {0}};
+    SimPolicy policy = SIM_ROUND_ROBIN;
+    int quantum = -1;   // 4 for round robin, otherwise run to completion or block
+    int available = 20;
+    int64_t until = INT64_MAX;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char *value = argv[i + 1];
+        if (strcmp(argv[i], "--workload") == 0) workload = value;
+        else if (strcmp(argv[i], "--count") == 0) params.count = (uint64_t)strtod(value, NULL);
+        else if (strcmp(argv[i], "--rate") == 0) params.arrivalRate = strtod(value, NULL);
+        else if (strcmp(argv[i], "--seed") == 0) params.seed = strtoull(value, NULL, 10);
+        else if (strcmp(argv[i], "--quantum") == 0) quantum = atoi(value);
+        else if (strcmp(argv[i], "--cpus") == 0) config.cpus = atoi(value);
+        else if (strcmp(argv[i], "--memory") == 0) config.totalMemory = atoi(value);
+        else if (strcmp(argv[i], "--available") == 0) available = atoi(value);
+        else if (strcmp(argv[i], "--until") == 0) until = strtoll(value, NULL, 10);
+        else if (strcmp(argv[i], "--scheduler") == 0) {
+            if (strcmp(value, "fcfs") == 0) policy = SIM_FCFS;
+            else if (strcmp(value, "sjf") == 0) policy = SIM_SJF;
+            else if (strcmp(value, "priority") == 0) policy = SIM_PRIORITY;
+            else policy = SIM_ROUND_ROBIN;
+        }
+        else if (strcmp(argv[i], "--strategy") == 0) {
+            if (strcmp(value, "best") == 0) config.strategy = BEST_FIT;
+            else if (strcmp(value, "worst") == 0) config.strategy = WORST_FIT;
+            else if (strcmp(value, "next") == 0) config.strategy = NEXT_FIT;
+        }
+    }
+    for (int j = 0; j < WORKLOAD_MAX_RESOURCES; j++) config.available[j] = available;
+    if (params.arrivalRate <= 0.0) {
+        fprintf(stderr, "Arrival rate must be positive\n");
+        return 2;
+    }
+
+    if (quantum < 0) quantum = policy == SIM_ROUND_ROBIN ? 4 : 0;
+    SimScheduler *scheduler = sim_scheduler_create(policy, quantum);
+    Sim *sim = (Sim*)malloc(sizeof(Sim));
+    if (sim == NULL || !sim_init(sim, &config, scheduler)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    if (workload != NULL) {
+        if (!sim_open_workload(sim, workload)) {
+            fprintf(stderr, "Cannot read job workload %s\n", workload);
+            return 1;
+        }
+    } else {
+        sim_generate_workload(sim, &params);
+    }
+
+    // Record step events to $EVLOG_PATH (builds with EVLOG_ENABLED)
+    EVLOG_START_FROM_ENV();
+    PROBE_HW_START();
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    sim_run(sim, until);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    PROBE_HW_STOP();
+    PROBE_REPORT();
+    EVLOG_STOP();
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    sim_report(sim, stdout);
+    printf("Wall time: %.3f s, %.2f M events/s\n", seconds,
+           seconds > 0 ? sim->stats.events / seconds / 1e6 : 0.0);
+
+    sim_free(sim);
+    free(sim);
+    sim_scheduler_destroy(scheduler);
+    return 0;
+}
+#endif
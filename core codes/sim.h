@@ -0,0 +1,165 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "mas.h"
+#include "dead.h"
+#include "workload.h"
+
+// Discrete-event simulation of the whole system on one timeline.
+//
+// Jobs arrive from a workload stream, take memory through allocate_memory(),
+// declare their maximum resource claims to the Banker's algorithm and request
+// half of them up front, then wait in a ready queue for one of the CPUs.
+// Halfway through its burst a job requests the rest of its claim; a refused
+// request blocks it, still holding its memory and first grant, until a
+// completion frees enough resources. Completions release everything and wake
+// blocked jobs in FIFO order.
+//
+// All state changes happen at events popped from one time-ordered heap;
+// ties break by insertion order, so a run is deterministic for a given
+// workload and configuration. Memory is taken before resources and a job
+// never waits for memory while holding resources, so the Banker's check
+// keeps the whole system deadlock-free.
+
+typedef enum {
+    SIM_EVENT_ARRIVAL,    // next job from the workload stream
+    SIM_EVENT_SLICE_END   // a CPU slice ended: quantum, mid-burst request or completion
+} SimEventType;
+
+typedef struct {
+    int64_t time;
+    uint64_t sequence;   // tie-breaker: insertion order
+    int32_t type;
+    int32_t process;     // index into Sim.processes
+} SimEvent;
+
+typedef enum {
+    SIM_WAITING_MEMORY,
+    SIM_WAITING_ADMISSION,   // holds memory, waiting to register with the Banker
+    SIM_READY,
+    SIM_RUNNING,
+    SIM_BLOCKED,             // holds memory and its first grant, waiting for the rest
+    SIM_DONE
+} SimProcessState;
+
+typedef struct {
+    WorkloadJob job;
+    char name[20];            // id shared with the allocator and the Banker
+    int state;
+    bool usesBanker;          // false for jobs with no resource claims
+    bool requestPending;      // second half of the claim not yet granted
+    int64_t remaining;        // CPU ticks left
+    int64_t untilRequest;     // CPU ticks until the mid-burst request
+    int64_t slice;            // length of the current slice
+    int64_t firstRun;         // -1 until first dispatched
+    int64_t waitStart;        // when the current wait began
+    int64_t readyWait;        // ticks in the ready queue
+    int64_t memoryWait;       // ticks waiting for memory
+    int64_t resourceWait;     // ticks waiting for the Banker
+    int next;                 // wait queue / free list link
+} SimProcess;
+
+// Pluggable ready-queue policy. enqueue() is called whenever a process
+// becomes ready; dequeue() returns the index to dispatch next, or -1.
+// A quantum of 0 runs each process until it completes or blocks.
+typedef struct SimScheduler {
+    const char *name;
+    int quantum;
+    void (*enqueue)(struct SimScheduler *self, const SimProcess *process, int index);
+    int (*dequeue)(struct SimScheduler *self);
+    void (*destroy)(struct SimScheduler *self);
+    void *state;
+} SimScheduler;
+
+typedef enum {
+    SIM_FCFS,
+    SIM_SJF,        // shortest remaining burst
+    SIM_PRIORITY,   // lowest priority value, then arrival
+    SIM_ROUND_ROBIN
+} SimPolicy;
+
+typedef struct {
+    int cpus;
+    int totalMemory;               // MB
+    AllocationStrategy strategy;
+    int available[WORKLOAD_MAX_RESOURCES];  // Banker's total of each resource
+} SimConfig;
+
+// Log-linear histogram of tick counts for percentiles
+#define SIM_HISTOGRAM_BUCKETS (64 * 16)
+
+typedef struct {
+    uint64_t counts[SIM_HISTOGRAM_BUCKETS];
+    uint64_t total;
+    double sum;
+} SimHistogram;
+
+typedef struct {
+    uint64_t events;
+    uint64_t arrived;
+    uint64_t completed;
+    uint64_t rejected;          // could never fit in memory or in the resource totals
+    uint64_t dispatches;
+    uint64_t memoryBlocks;      // arrivals that had to wait for memory
+    uint64_t admissionBlocks;   // jobs that had to wait to register with the Banker
+    uint64_t requestBlocks;     // mid-burst requests refused
+    int64_t busyTicks;          // summed over CPUs
+    int64_t makespan;
+    SimHistogram turnaround;
+    SimHistogram response;
+    SimHistogram readyWait;
+    SimHistogram memoryWait;
+    SimHistogram resourceWait;
+} SimStats;
+
+typedef struct {
+    SimConfig config;
+    SimScheduler *scheduler;
+    int64_t now;
+    uint64_t sequence;
+
+    SimEvent *events;           // binary min-heap on (time, sequence)
+    int eventCount;
+    int eventCapacity;
+
+    SimProcess *processes;      // in-flight jobs; slots recycled through freeList
+    int processCapacity;
+    int freeList;
+
+    // FIFO wait queues linked through SimProcess.next
+    int memoryHead, memoryTail;
+    int admissionHead, admissionTail;
+    int blockedHead, blockedTail;
+
+    int idleCpus;
+    MemoryManager *memory;
+    BankerState banker;
+
+    // Job source: a workload file, or the generator when file is NULL
+    FILE *file;
+    WorkloadJobParams params;
+    WorkloadJob *jobs;
+    size_t jobCount;
+    size_t jobNext;
+    uint64_t generated;
+    double clock;
+
+    SimStats stats;
+} Sim;
+
+SimScheduler *sim_scheduler_create(SimPolicy policy, int quantum);
+void sim_scheduler_destroy(SimScheduler *scheduler);
+
+bool sim_init(Sim *sim, const SimConfig *config, SimScheduler *scheduler);
+bool sim_open_workload(Sim *sim, const char *path);
+void sim_generate_workload(Sim *sim, const WorkloadJobParams *params);
+void sim_run(Sim *sim, int64_t until);
+void sim_free(Sim *sim);
+
+uint64_t sim_percentile(const SimHistogram *histogram, double fraction);
+void sim_report(const Sim *sim, FILE *out);
+
+#endif
@@ -0,0 +1,117 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "snapshot.h"
+
+_Static_assert(sizeof(SnapshotHeader) == SNAPSHOT_PAYLOAD_OFFSET, "SnapshotHeader must fill the payload offset");
+
+static bool write_fully(int fd, const void *buffer, size_t count) {
+    size_t done = 0;
+    while (done < count) {
+        ssize_t put = write(fd, (const char*)buffer + done, count - done);
+        if (put < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        done += put;
+    }
+    return true;
+}
+
+// Write a checkpoint atomically: the data goes to a temporary file that is
+// synced and renamed over path, so readers see the old or the new snapshot
+bool snapshot_write(const char *path, SnapshotKind kind, const void *state, size_t size) {
+    char temp_path[4096];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+
+    int fd = open(temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.kind = (uint16_t)kind;
+    header.payloadOffset = SNAPSHOT_PAYLOAD_OFFSET;
+    header.payloadSize = size;
+
+    bool ok = write_fully(fd, &header, sizeof(header)) &&
+              write_fully(fd, state, size) &&
+              fsync(fd) == 0;
+    if (close(fd) < 0) ok = false;
+
+    if (!ok || rename(temp_path, path) < 0) {
+        unlink(temp_path);
+        return false;
+    }
+    return true;
+}
+
+// Map a snapshot and return a pointer to its payload, or NULL (errno set)
+// if the file is missing, truncated, or of another kind, version or size
+void *snapshot_map(const char *path, SnapshotKind kind, size_t size, SnapshotMode mode, SnapshotMapping *mapping) {
+    mapping->base = NULL;
+    mapping->length = 0;
+
+    int fd = open(path, mode == SNAPSHOT_SHARED ? O_RDWR : O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat info;
+    if (fstat(fd, &info) < 0 || (size_t)info.st_size < SNAPSHOT_PAYLOAD_OFFSET + size) {
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    int protection = mode == SNAPSHOT_READ_ONLY ? PROT_READ : PROT_READ | PROT_WRITE;
+    int flags = mode == SNAPSHOT_PRIVATE ? MAP_PRIVATE : MAP_SHARED;
+    void *base = mmap(NULL, info.st_size, protection, flags, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return NULL;
+
+    const SnapshotHeader *header = (const SnapshotHeader*)base;
+    if (header->magic != SNAPSHOT_MAGIC || header->version != SNAPSHOT_VERSION ||
+        header->kind != kind || header->payloadOffset != SNAPSHOT_PAYLOAD_OFFSET ||
+        header->payloadSize != size) {
+        munmap(base, info.st_size);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    mapping->base = base;
+    mapping->length = info.st_size;
+    return (char*)base + SNAPSHOT_PAYLOAD_OFFSET;
+}
+
+// Flush a SNAPSHOT_SHARED mapping's changes to its file
+bool snapshot_sync(SnapshotMapping *mapping) {
+    return mapping->base != NULL && msync(mapping->base, mapping->length, MS_SYNC) == 0;
+}
+
+void snapshot_unmap(SnapshotMapping *mapping) {
+    if (mapping->base != NULL) munmap(mapping->base, mapping->length);
+    mapping->base = NULL;
+    mapping->length = 0;
+}
+
+bool snapshot_save_memory_manager(const char *path, const MemoryManager *manager) {
+    return snapshot_write(path, SNAPSHOT_MEMORY_MANAGER, manager, sizeof(MemoryManager));
+}
+
+MemoryManager *snapshot_map_memory_manager(const char *path, SnapshotMode mode, SnapshotMapping *mapping) {
+    return (MemoryManager*)snapshot_map(path, SNAPSHOT_MEMORY_MANAGER, sizeof(MemoryManager), mode, mapping);
+}
+
+bool snapshot_save_banker(const char *path, const BankerState *state) {
+    return snapshot_write(path, SNAPSHOT_BANKER, state, sizeof(BankerState));
+}
+
+// Map a Banker's state; assign the result to bankerState to run the engine on it
+BankerState *snapshot_map_banker(const char *path, SnapshotMode mode, SnapshotMapping *mapping) {
+    return (BankerState*)snapshot_map(path, SNAPSHOT_BANKER, sizeof(BankerState), mode, mapping);
+}
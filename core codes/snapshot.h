@@ -0,0 +1,58 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "mas.h"
+#include "dead.h"
+
+// Snapshot and restore of engine state through memory-mapped files.
+//
+// A snapshot is a 64-byte header followed by the engine's state struct.
+// MemoryManager and BankerState are plain data with no pointers, so the
+// payload is used in place once mapped: restoring costs one mmap and a
+// header check, not parsing or replaying calls. The header records the
+// layout version and payload size, and a mismatch is rejected rather than
+// misread. Files use native byte order and are not portable across ABIs.
+
+#define SNAPSHOT_MAGIC 0x534B534Fu  // "OSKS"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_PAYLOAD_OFFSET 64
+
+typedef enum {
+    SNAPSHOT_MEMORY_MANAGER = 1,
+    SNAPSHOT_BANKER = 2
+} SnapshotKind;
+
+typedef enum {
+    SNAPSHOT_READ_ONLY,   // shared read-only view of the checkpoint
+    SNAPSHOT_PRIVATE,     // copy-on-write branch; changes never reach the file
+    SNAPSHOT_SHARED       // writable view; changes persist to the file
+} SnapshotMode;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t kind;
+    uint64_t payloadOffset;
+    uint64_t payloadSize;
+    uint8_t reserved[SNAPSHOT_PAYLOAD_OFFSET - 24];
+} SnapshotHeader;
+
+typedef struct {
+    void *base;
+    size_t length;
+} SnapshotMapping;
+
+bool snapshot_write(const char *path, SnapshotKind kind, const void *state, size_t size);
+void *snapshot_map(const char *path, SnapshotKind kind, size_t size, SnapshotMode mode, SnapshotMapping *mapping);
+bool snapshot_sync(SnapshotMapping *mapping);
+void snapshot_unmap(SnapshotMapping *mapping);
+
+bool snapshot_save_memory_manager(const char *path, const MemoryManager *manager);
+MemoryManager *snapshot_map_memory_manager(const char *path, SnapshotMode mode, SnapshotMapping *mapping);
+bool snapshot_save_banker(const char *path, const BankerState *state);
+BankerState *snapshot_map_banker(const char *path, SnapshotMode mode, SnapshotMapping *mapping);
+
+#endif
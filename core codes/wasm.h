@@ -0,0 +1,13 @@
+#ifndef WASM_H
+#define WASM_H
+
+// Marks functions exported from the WebAssembly module; a no-op for native
+// builds so the glue still compiles (and can be tested) with a host compiler
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#define WASM_EXPORT EMSCRIPTEN_KEEPALIVE
+#else
+#define WASM_EXPORT
+#endif
+
+#endif
@@ -0,0 +1,254 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include "workload.h"
+
+const char *const workload_distribution_names[DIST_COUNT] = {
+    "uniform", "sorted", "reverse", "few-unique", "zipf", "organ-pipe"
+};
+
+#define FEW_UNIQUE_VALUES 16
+
+// Independent key per job field, so adding a field never shifts the others
+enum { FIELD_ARRIVAL, FIELD_BURST, FIELD_MEMORY, FIELD_PRIORITY, FIELD_DEMAND, FIELD_COUNT };
+
+static double zipf_helper1(double x) {
+    return fabs(x) > 1e-8 ? log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+
+static double zipf_helper2(double x) {
+    return fabs(x) > 1e-8 ? expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x / 3.0 * (1.0 + 0.25 * x));
+}
+
+static double zipf_h(const ZipfSampler *sampler, double x) {
+    return exp(-sampler->exponent * log(x));
+}
+
+static double zipf_h_integral(const ZipfSampler *sampler, double x) {
+    double log_x = log(x);
+    return zipf_helper2((1.0 - sampler->exponent) * log_x) * log_x;
+}
+
+static double zipf_h_integral_inverse(const ZipfSampler *sampler, double x) {
+    double t = x * (1.0 - sampler->exponent);
+    if (t < -1.0) t = -1.0;
+    return exp(zipf_helper1(t) * x);
+}
+
+void zipf_init(ZipfSampler *sampler, int elements, double exponent) {
+    sampler->exponent = exponent;
+    sampler->elements = elements < 1 ? 1 : elements;
+    sampler->hIntegralX1 = zipf_h_integral(sampler, 1.5) - 1.0;
+    sampler->hIntegralN = zipf_h_integral(sampler, sampler->elements + 0.5);
+    sampler->s = 2.0 - zipf_h_integral_inverse(sampler, zipf_h_integral(sampler, 2.5) - zipf_h(sampler, 2.0));
+}
+
+// Draws a rank in 1..elements; rank 1 is the most frequent
+int zipf_sample(const ZipfSampler *sampler, uint64_t key, uint64_t index) {
+    for (uint64_t draw = 0;; draw++) {
+        double u = sampler->hIntegralN + workload_unit_at(key, index, draw) * (sampler->hIntegralX1 - sampler->hIntegralN);
+        double x = zipf_h_integral_inverse(sampler, u);
+        int k = (int)(x + 0.5);
+        if (k < 1) k = 1;
+        if (k > sampler->elements) k = sampler->elements;
+        if (k - x <= sampler->s || u >= zipf_h_integral(sampler, k + 0.5) - zipf_h(sampler, k))
+            return k;
+    }
+}
+
+// Inverse CDF of the Pareto distribution truncated to [min, max]
+int workload_pareto(const WorkloadPareto *pareto, double unit) {
+    if (pareto->max <= pareto->min) return pareto->min;
+    double low = pow((double)pareto->min, -pareto->alpha);
+    double high = pow((double)pareto->max, -pareto->alpha);
+    double value = pow(low - unit * (low - high), -1.0 / pareto->alpha);
+    int result = (int)value;
+    return result < pareto->min ? pareto->min : result > pareto->max ? pareto->max : result;
+}
+
+// Gap between arrivals of a Poisson process with the given rate
+double workload_exponential(double rate, double unit) {
+    return -log1p(-unit) / rate;
+}
+
+void workload_default_job_params(WorkloadJobParams *params) {
+    memset(params, 0, sizeof(*params));
+    params->seed = 42;
+    params->count = 1000000;
+    params->arrivalRate = 0.3;
+    params->burst = (WorkloadPareto){1, 1000, 1.5};
+    params->memory = (WorkloadPareto){1, 512, 1.2};
+    params->priorityLevels = 10;
+    params->priorityExponent = 1.1;
+    params->resourceCount = 3;
+    params->resourceMax = 5;
+    params->resourceDensity = 0.5;
+}
+
+// Fill arr with elements [offset, offset + n) of a total-element input.
+// The key depends on the distribution and total, so a chunk matches the same
+// range of an input generated in one piece.
+void workload_fill_ints(int *arr, size_t offset, size_t n, uint64_t total, Distribution dist,
+                        uint64_t seed, double skew) {
+    uint64_t key = workload_mix64(seed ^ ((uint64_t)dist << 56) ^ total);
+    ZipfSampler zipf;
+    if (dist == DIST_ZIPF)
+        zipf_init(&zipf, total > INT_MAX ? INT_MAX : (int)total, skew);
+
+    #pragma omp parallel for schedule(static)
+    for (size_t j = 0; j < n; j++) {
+        uint64_t i = offset + j;
+        switch (dist) {
+            case DIST_UNIFORM:
+                arr[j] = (int)(uint32_t)workload_random_at(key, i, 0);
+                break;
+            case DIST_SORTED:
+                arr[j] = (int)i;
+                break;
+            case DIST_REVERSE:
+                arr[j] = (int)(total - 1 - i);
+                break;
+            case DIST_FEW_UNIQUE:
+                arr[j] = (int)(workload_random_at(key, i, 0) % FEW_UNIQUE_VALUES);
+                break;
+            case DIST_ZIPF:
+                arr[j] = zipf_sample(&zipf, key, i);
+                break;
+            case DIST_ORGAN_PIPE:
+                arr[j] = (int)(i < total / 2 ? i : total - 1 - i);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// Fill jobs [offset, offset + n). clock carries the arrival time across
+// chunks and must start at 0; arrivals saturate at INT_MAX ticks.
+void workload_fill_jobs(WorkloadJob *jobs, size_t offset, size_t n, const WorkloadJobParams *params,
+                        double *clock) {
+    uint64_t keys[FIELD_COUNT];
+    for (int f = 0; f < FIELD_COUNT; f++)
+        keys[f] = workload_mix64(params->seed ^ workload_mix64(f + 1));
+
+    ZipfSampler priorities;
+    zipf_init(&priorities, params->priorityLevels, params->priorityExponent);
+    int resources = params->resourceCount < WORKLOAD_MAX_RESOURCES ? params->resourceCount : WORKLOAD_MAX_RESOURCES;
+
+    #pragma omp parallel for schedule(static)
+    for (size_t j = 0; j < n; j++) {
+        uint64_t i = offset + j;
+        WorkloadJob *job = &jobs[j];
+        memset(job, 0, sizeof(*job));
+        job->id = (int32_t)i;
+        job->burst = workload_pareto(&params->burst, workload_unit_at(keys[FIELD_BURST], i, 0));
+        job->memory = workload_pareto(&params->memory, workload_unit_at(keys[FIELD_MEMORY], i, 0));
+        job->priority = zipf_sample(&priorities, keys[FIELD_PRIORITY], i);
+        for (int r = 0; r < resources; r++) {
+            if (workload_unit_at(keys[FIELD_DEMAND], i, 2 * r) < params->resourceDensity)
+                job->demand[r] = 1 + (int)(workload_random_at(keys[FIELD_DEMAND], i, 2 * r + 1) % params->resourceMax);
+        }
+    }
+
+    // Arrivals are a running sum, so they are the one serial step
+    double now = *clock;
+    for (size_t j = 0; j < n; j++) {
+        now += workload_exponential(params->arrivalRate, workload_unit_at(keys[FIELD_ARRIVAL], offset + j, 0));
+        jobs[j].arrival = now < INT_MAX ? (int32_t)now : INT_MAX;
+    }
+    *clock = now;
+}
+
+static bool write_header(FILE *file, WorkloadKind kind, uint32_t record_size, uint32_t resources,
+                         uint64_t count, uint64_t seed) {
+    WorkloadFileHeader header = {WORKLOAD_MAGIC, WORKLOAD_VERSION, (uint16_t)kind, record_size,
+                                 resources, count, seed};
+    return fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+// Stream params->count ints to path. raw omits the header, giving the plain
+// int32 file that externalSort() reads.
+bool workload_write_ints(const char *path, const WorkloadIntParams *params, bool raw) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) return false;
+
+    int *chunk = (int*)malloc(WORKLOAD_CHUNK * sizeof(int));
+    bool ok = chunk != NULL &&
+              (raw || write_header(file, WORKLOAD_INTS, sizeof(int32_t), 0, params->count, params->seed));
+
+    for (uint64_t offset = 0; ok && offset < params->count; offset += WORKLOAD_CHUNK) {
+        size_t n = params->count - offset < WORKLOAD_CHUNK ? (size_t)(params->count - offset) : WORKLOAD_CHUNK;
+        workload_fill_ints(chunk, offset, n, params->count, params->distribution, params->seed, params->skew);
+        ok = fwrite(chunk, sizeof(int), n, file) == n;
+    }
+
+    free(chunk);
+    if (fclose(file) != 0) ok = false;
+    return ok;
+}
+
+bool workload_write_jobs(const char *path, const WorkloadJobParams *params) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) return false;
+
+    WorkloadJob *chunk = (WorkloadJob*)malloc(WORKLOAD_CHUNK * sizeof(WorkloadJob));
+    bool ok = chunk != NULL &&
+              write_header(file, WORKLOAD_JOBS, sizeof(WorkloadJob), params->resourceCount, params->count, params->seed);
+    double clock = 0.0;
+
+    for (uint64_t offset = 0; ok && offset < params->count; offset += WORKLOAD_CHUNK) {
+        size_t n = params->count - offset < WORKLOAD_CHUNK ? (size_t)(params->count - offset) : WORKLOAD_CHUNK;
+        workload_fill_jobs(chunk, offset, n, params, &clock);
+        ok = fwrite(chunk, sizeof(WorkloadJob), n, file) == n;
+    }
+
+    free(chunk);
+    if (fclose(file) != 0) ok = false;
+    return ok;
+}
+
+// Open a workload file positioned at its first record, for streaming reads
+FILE *workload_open(const char *path, WorkloadKind kind, WorkloadFileHeader *header) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return NULL;
+
+    uint32_t record_size = kind == WORKLOAD_JOBS ? sizeof(WorkloadJob) : sizeof(int32_t);
+    if (fread(header, sizeof(*header), 1, file) != 1 || header->magic != WORKLOAD_MAGIC ||
+        header->version != WORKLOAD_VERSION || header->kind != kind || header->recordSize != record_size) {
+        fclose(file);
+        return NULL;
+    }
+    return file;
+}
+
+static void *load_records(const char *path, WorkloadKind kind, WorkloadFileHeader *header) {
+    FILE *file = workload_open(path, kind, header);
+    if (file == NULL) return NULL;
+
+    void *records = malloc(header->count ? header->count * header->recordSize : 1);
+    if (records != NULL && fread(records, header->recordSize, header->count, file) != header->count) {
+        free(records);
+        records = NULL;
+    }
+    fclose(file);
+    return records;
+}
+
+int *workload_load_ints(const char *path, size_t *count) {
+    WorkloadFileHeader header;
+    int *values = (int*)load_records(path, WORKLOAD_INTS, &header);
+    *count = values ? header.count : 0;
+    return values;
+}
+
+WorkloadJob *workload_load_jobs(const char *path, WorkloadFileHeader *header) {
+    return (WorkloadJob*)load_records(path, WORKLOAD_JOBS, header);
+}
+
+int workload_parse_distribution(const char *name) {
+    for (int i = 0; i < DIST_COUNT; i++) {
+        if (strcmp(name, workload_distribution_names[i]) == 0) return i;
+    }
+    return -1;
+}
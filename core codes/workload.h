@@ -0,0 +1,152 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Seeded workload generation shared by the engines and benchmarks.
+//
+// Every random value is a pure function of (key, index, draw): a counter-
+// based generator with no hidden state, so any thread can produce any record
+// and the output is identical for every thread count. workload_rng() splits
+// a seed into independent streams for callers that want a sequential
+// generator per thread.
+//
+// Generated inputs stream to binary files in fixed-size chunks, so the count
+// is bounded by disk, not memory. A file is a WorkloadFileHeader followed by
+// records of the kind it names: int32 values (sort input) or WorkloadJob
+// records (scheduler, allocator and Banker's input). Files use native byte
+// order.
+
+#define WORKLOAD_MAGIC 0x444C4B57u  // "WKLD"
+#define WORKLOAD_VERSION 1
+#define WORKLOAD_MAX_RESOURCES 10   // matches MAX_RESOURCES in dead.h
+#define WORKLOAD_CHUNK (1u << 16)   // records generated and written per batch
+
+typedef enum {
+    WORKLOAD_INTS = 1,
+    WORKLOAD_JOBS = 2
+} WorkloadKind;
+
+// Integer distributions for the sorting engines
+typedef enum {
+    DIST_UNIFORM,
+    DIST_SORTED,
+    DIST_REVERSE,
+    DIST_FEW_UNIQUE,
+    DIST_ZIPF,
+    DIST_ORGAN_PIPE,
+    DIST_COUNT
+} Distribution;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t kind;
+    uint32_t recordSize;
+    uint32_t resourceCount;   // resources per job (jobs only)
+    uint64_t count;
+    uint64_t seed;
+} WorkloadFileHeader;
+
+typedef struct {
+    int32_t id;
+    int32_t arrival;          // ticks; Poisson process
+    int32_t burst;            // CPU ticks; bounded Pareto
+    int32_t priority;         // 1 is most common; Zipf
+    int32_t memory;           // MB; bounded Pareto
+    int32_t demand[WORKLOAD_MAX_RESOURCES];  // maximum claim per resource
+} WorkloadJob;
+
+// Bounded Pareto: values in [min, max], shape alpha (smaller is heavier)
+typedef struct {
+    int min;
+    int max;
+    double alpha;
+} WorkloadPareto;
+
+typedef struct {
+    uint64_t seed;
+    uint64_t count;
+    double arrivalRate;       // mean arrivals per tick
+    WorkloadPareto burst;
+    WorkloadPareto memory;
+    int priorityLevels;
+    double priorityExponent;
+    int resourceCount;
+    int resourceMax;          // largest claim on a single resource
+    double resourceDensity;   // probability a job claims a given resource
+} WorkloadJobParams;
+
+typedef struct {
+    uint64_t seed;
+    uint64_t count;
+    Distribution distribution;
+    double skew;              // Zipf exponent for DIST_ZIPF
+} WorkloadIntParams;
+
+// Rejection-inversion Zipf sampler over 1..elements (Hormann and Derflinger)
+typedef struct {
+    double exponent;
+    double hIntegralX1;
+    double hIntegralN;
+    double s;
+    int elements;
+} ZipfSampler;
+
+// Sequential view of one stream
+typedef struct {
+    uint64_t key;
+    uint64_t counter;
+} WorkloadRng;
+
+extern const char *const workload_distribution_names[DIST_COUNT];
+
+// SplitMix64 finalizer
+static inline uint64_t workload_mix64(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t workload_random_at(uint64_t key, uint64_t index, uint64_t draw) {
+    return workload_mix64(workload_mix64(key ^ index) + draw);
+}
+
+// Uniform double in [0, 1)
+static inline double workload_unit_at(uint64_t key, uint64_t index, uint64_t draw) {
+    return (workload_random_at(key, index, draw) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static inline WorkloadRng workload_rng(uint64_t seed, uint64_t stream) {
+    WorkloadRng rng = {workload_mix64(seed ^ workload_mix64(stream)), 0};
+    return rng;
+}
+
+static inline uint64_t workload_next(WorkloadRng *rng) {
+    return workload_random_at(rng->key, rng->counter++, 0);
+}
+
+void zipf_init(ZipfSampler *sampler, int elements, double exponent);
+int zipf_sample(const ZipfSampler *sampler, uint64_t key, uint64_t index);
+int workload_pareto(const WorkloadPareto *pareto, double unit);
+double workload_exponential(double rate, double unit);
+
+void workload_default_job_params(WorkloadJobParams *params);
+void workload_fill_ints(int *arr, size_t offset, size_t n, uint64_t total, Distribution dist,
+                        uint64_t seed, double skew);
+void workload_fill_jobs(WorkloadJob *jobs, size_t offset, size_t n, const WorkloadJobParams *params,
+                        double *clock);
+
+bool workload_write_ints(const char *path, const WorkloadIntParams *params, bool raw);
+bool workload_write_jobs(const char *path, const WorkloadJobParams *params);
+
+FILE *workload_open(const char *path, WorkloadKind kind, WorkloadFileHeader *header);
+int *workload_load_ints(const char *path, size_t *count);
+WorkloadJob *workload_load_jobs(const char *path, WorkloadFileHeader *header);
+int workload_parse_distribution(const char *name);
+
+#endif
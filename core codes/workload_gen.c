@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "workload.h"
+
+// Writes seeded workload files for the engines.
+// Usage: workload_gen ints <file> [--count N] [--dist NAME] [--skew S] [--seed S] [--raw]
+//        workload_gen jobs <file> [--count N] [--rate R] [--burst MIN,MAX,ALPHA]
+//                                 [--memory MIN,MAX,ALPHA] [--priorities LEVELS,EXPONENT]
+//                                 [--resources COUNT,MAX,DENSITY] [--seed S]
+
+static void usage(const char *program) {
+    fprintf(stderr, "Usage: %s ints <file> [--count N] [--dist uniform|sorted|reverse|few-unique|zipf|organ-pipe]\n"
+                    "                  [--skew S] [--seed S] [--raw]\n"
+                    "       %s jobs <file> [--count N] [--rate R] [--burst MIN,MAX,ALPHA]\n"
+                    "                  [--memory MIN,MAX,ALPHA] [--priorities LEVELS,EXPONENT]\n"
+                    "                  [--resources COUNT,MAX,DENSITY] [--seed S]\n",
+            program, program);
+}
+
+static void parse_pareto(const char *text, WorkloadPareto *pareto) {
+    sscanf(text, "%d,%d,%lf", &pareto->min, &pareto->max, &pareto->alpha);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3 || (strcmp(argv[1], "ints") != 0 && strcmp(argv[1], "jobs") != 0)) {
+        usage(argv[0]);
+        return 2;
+    }
+    const char *path = argv[2];
+
+    if (strcmp(argv[1], "ints") == 0) {
+        WorkloadIntParams params = {42, 1000000, DIST_UNIFORM, 1.1};
+        bool raw = false;
+        for (int i = 3; i < argc; i++) {
+            if (strcmp(argv[i], "--raw") == 0)
+                raw = true;
+            else if (i + 1 >= argc)
+                break;
+            else if (strcmp(argv[i], "--count") == 0)
+                params.count = (uint64_t)strtod(argv[++i], NULL);
+            else if (strcmp(argv[i], "--dist") == 0) {
+                int dist = workload_parse_distribution(argv[++i]);
+                if (dist < 0) {
+                    fprintf(stderr, "Unknown distribution: %s\n", argv[i]);
+                    return 2;
+                }
+                params.distribution = (Distribution)dist;
+            }
+            else if (strcmp(argv[i], "--skew") == 0)
+                params.skew = strtod(argv[++i], NULL);
+            else if (strcmp(argv[i], "--seed") == 0)
+                params.seed = strtoull(argv[++i], NULL, 10);
+        }
+
+        if (!workload_write_ints(path, &params, raw)) {
+            perror(path);
+            return 1;
+        }
+        fprintf(stderr, "Wrote %llu %s ints to %s\n", (unsigned long long)params.count,
+                workload_distribution_names[params.distribution], path);
+        return 0;
+    }
+
+    WorkloadJobParams params;
+    workload_default_job_params(&params);
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--count") == 0)
+            params.count = (uint64_t)strtod(argv[i + 1], NULL);
+        else if (strcmp(argv[i], "--rate") == 0)
+            params.arrivalRate = strtod(argv[i + 1], NULL);
+        else if (strcmp(argv[i], "--burst") == 0)
+            parse_pareto(argv[i + 1], &params.burst);
+        else if (strcmp(argv[i], "--memory") == 0)
+            parse_pareto(argv[i + 1], &params.memory);
+        else if (strcmp(argv[i], "--priorities") == 0)
+            sscanf(argv[i + 1], "%d,%lf", &params.priorityLevels, &params.priorityExponent);
+        else if (strcmp(argv[i], "--resources") == 0)
+            sscanf(argv[i + 1], "%d,%d,%lf", &params.resourceCount, &params.resourceMax, &params.resourceDensity);
+        else if (strcmp(argv[i], "--seed") == 0)
+            params.seed = strtoull(argv[i + 1], NULL, 10);
+    }
+
+    if (params.arrivalRate <= 0.0 || params.burst.min < 1 || params.memory.min < 1 ||
+        params.burst.alpha <= 0.0 || params.memory.alpha <= 0.0 || params.priorityLevels < 1 ||
+        params.resourceMax < 1 || params.resourceCount < 0 || params.resourceCount > WORKLOAD_MAX_RESOURCES) {
+        fprintf(stderr, "Invalid parameters: rate and alphas must be positive, minimums at least 1, "
+                        "0 <= resources <= %d\n", WORKLOAD_MAX_RESOURCES);
+        return 2;
+    }
+
+    if (!workload_write_jobs(path, &params)) {
+        perror(path);
+        return 1;
+    }
+    fprintf(stderr, "Wrote %llu jobs to %s\n", (unsigned long long)params.count, path);
+    return 0;
+}
@@ -0,0 +1,25 @@
+#!/bin/sh
+# Compile the C engines in "core codes/" into a single WebAssembly module
+# (public/wasm/engines.mjs + engines.wasm) for src/lib/engines.ts.
+# Requires the Emscripten SDK (emcc) on PATH.
+set -e
+
+cd "$(dirname "$0")/.."
+SRC="core codes"
+OUT="public/wasm"
+mkdir -p "$OUT"
+
+emcc -O3 \
+  -DMSV_NO_MAIN -DPSV_NO_MAIN -DMAS_NO_MAIN -DDEAD_NO_MAIN \
+  "$SRC/msv.c" "$SRC/psv.c" "$SRC/mas.c" "$SRC/dead.c" \
+  "$SRC/msv_wasm.c" "$SRC/psv_wasm.c" "$SRC/mas_wasm.c" "$SRC/dead_wasm.c" \
+  -sMODULARIZE=1 \
+  -sEXPORT_ES6=1 \
+  -sEXPORT_NAME=createEngines \
+  -sALLOW_MEMORY_GROWTH=1 \
+  -sENVIRONMENT=web,worker \
+  -sEXPORTED_FUNCTIONS=_malloc,_free \
+  -sEXPORTED_RUNTIME_METHODS=HEAP32,HEAPF64 \
+  -o "$OUT/engines.mjs"
+
+echo "Built $OUT/engines.mjs"
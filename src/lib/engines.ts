@@ -0,0 +1,136 @@
+// Typed bindings for the WebAssembly build of the C engines in `core codes/`.
+// Build the module with `npm run build:wasm`. loadEngines() resolves to null
+// when it hasn't been built, so pages can keep their JavaScript fallbacks.
+//
+// Results are Int32Array views directly over module memory, not copies. A view
+// is only valid until the next call into the same engine (or until memory
+// grows), so read it or copy it before calling again.
+
+interface EngineModule {
+  HEAP32: Int32Array;
+  HEAPF64: Float64Array;
+  _malloc(size: number): number;
+  _free(ptr: number): void;
+  _msvSort(algorithm: number, arr: number, n: number): void;
+  _psv_schedule(algorithm: number, records: number, n: number, quantum: number): number;
+  _psv_steps(): number;
+  _psv_processes(): number;
+  _mas_init(totalMemory: number, strategy: number): void;
+  _mas_set_time(currentTime: number): void;
+  _mas_allocate(size: number): number;
+  _mas_deallocate(slot: number): void;
+  _mas_blocks(): number;
+  _mas_block_count(): number;
+  _mas_fragmentation(): number;
+  _deadReset(resources: number, available: number): void;
+  _deadAddProcess(allocation: number, max: number, priority: number): number;
+  _deadRelease(index: number): void;
+  _deadCheck(): number;
+  _deadSafeSequence(): number;
+  _deadSafeSequenceCount(): number;
+}
+
+export const SortAlgorithm = { quick: 0, merge: 1, bucket: 2, radix: 3 } as const;
+export const ScheduleAlgorithm = { fcfs: 0, sjf: 1, priority: 2, robin: 3 } as const;
+export const AllocationStrategy = { firstFit: 0, bestFit: 1, worstFit: 2, nextFit: 3 } as const;
+
+// Record layouts (in ints) of the views returned below
+export const PROCESS_INPUT_STRIDE = 4;   // process_id, arrival_time, burst_time, priority
+export const EXECUTION_STEP_STRIDE = 3;  // process_id, start_time, duration
+export const PROCESS_STRIDE = 8;         // id, arrival, burst, priority, remaining, completion, waiting, turnaround
+export const MEMORY_BLOCK_STRIDE = 5;    // start, end, size, is_free, process_slot
+
+export interface Engines {
+  sort(algorithm: number, values: Int32Array): Int32Array;
+  schedule(algorithm: number, processes: Int32Array, quantum: number): { steps: Int32Array; processes: Int32Array };
+  memory: {
+    init(totalMemory: number, strategy: number): void;
+    setTime(currentTime: number): void;
+    allocate(size: number): number;
+    deallocate(slot: number): void;
+    blocks(): Int32Array;
+    fragmentation(): number;
+  };
+  banker: {
+    reset(available: Int32Array): void;
+    addProcess(allocation: Int32Array, max: Int32Array, priority: number): number;
+    release(index: number): void;
+    check(): { safe: boolean; sequence: Int32Array };
+  };
+}
+
+const bindEngines = (module: EngineModule): Engines => {
+  // One reusable input buffer per engine, grown as needed
+  const scratch: Record<string, { ptr: number; length: number }> = {};
+
+  const copyIn = (name: string, values: Int32Array): number => {
+    const buffer = scratch[name];
+    if (!buffer || buffer.length < values.length) {
+      if (buffer) module._free(buffer.ptr);
+      scratch[name] = { ptr: module._malloc(Math.max(values.length, 1) * 4), length: values.length };
+    }
+    const ptr = scratch[name].ptr;
+    module.HEAP32.set(values, ptr >> 2);
+    return ptr;
+  };
+
+  const view = (ptr: number, length: number): Int32Array =>
+    new Int32Array(module.HEAP32.buffer, ptr, length);
+
+  return {
+    sort(algorithm, values) {
+      const ptr = copyIn('sort', values);
+      module._msvSort(algorithm, ptr, values.length);
+      return view(ptr, values.length);
+    },
+
+    schedule(algorithm, processes, quantum) {
+      const n = processes.length / PROCESS_INPUT_STRIDE;
+      const ptr = copyIn('schedule', processes);
+      const stepCount = module._psv_schedule(algorithm, ptr, n, quantum);
+      if (stepCount < 0) throw new RangeError('schedule failed: unknown algorithm, quantum or burst time not positive, or out of memory');
+      return {
+        steps: view(module._psv_steps(), stepCount * EXECUTION_STEP_STRIDE),
+        processes: view(module._psv_processes(), n * PROCESS_STRIDE)
+      };
+    },
+
+    memory: {
+      init: (totalMemory, strategy) => module._mas_init(totalMemory, strategy),
+      setTime: (currentTime) => module._mas_set_time(currentTime),
+      allocate: (size) => module._mas_allocate(size),
+      deallocate: (slot) => module._mas_deallocate(slot),
+      blocks: () => view(module._mas_blocks(), module._mas_block_count() * MEMORY_BLOCK_STRIDE),
+      fragmentation: () => module._mas_fragmentation()
+    },
+
+    banker: {
+      reset(available) {
+        module._deadReset(available.length, copyIn('available', available));
+      },
+      addProcess(allocation, max, priority) {
+        const allocationPtr = copyIn('allocation', allocation);
+        const maxPtr = copyIn('max', max);
+        return module._deadAddProcess(allocationPtr, maxPtr, priority);
+      },
+      release: (index) => module._deadRelease(index),
+      check() {
+        const safe = module._deadCheck() === 1;
+        return { safe, sequence: view(module._deadSafeSequence(), module._deadSafeSequenceCount()) };
+      }
+    }
+  };
+};
+
+let enginesPromise: Promise<Engines | null> | null = null;
+
+export const loadEngines = (): Promise<Engines | null> => {
+  if (!enginesPromise) {
+    const url = `${import.meta.env.BASE_URL}wasm/engines.mjs`;
+    enginesPromise = import(/* @vite-ignore */ url)
+      .then((factory: { default: () => Promise<EngineModule> }) => factory.default())
+      .then(bindEngines)
+      .catch(() => null);
+  }
+  return enginesPromise;
+};